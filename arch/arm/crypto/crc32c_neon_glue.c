@@ -0,0 +1,178 @@
+/*
+ * Glue code for CRC32C using the NEON folding code in crc32-armv7-neon.S.
+ *
+ * Buffers are folded 64 bytes at a time with NEON; the head and tail,
+ * short buffers and contexts where NEON can not be used go through the
+ * table driven __crc32c_le() of lib/crc32.c.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ */
+
+#include <crypto/internal/hash.h>
+#include <linux/init.h>
+#include <linux/module.h>
+#include <linux/string.h>
+#include <linux/kernel.h>
+#include <linux/crc32.h>
+#include <asm/unaligned.h>
+#include <asm/simd.h>
+#include <asm/neon.h>
+
+#define CHKSUM_BLOCK_SIZE	1
+#define CHKSUM_DIGEST_SIZE	4
+
+#define CRC32_FOLD_SIZE		64
+
+/* below this, the scalar tail reduction costs more than folding saves */
+#define CRC32_NEON_MIN_LEN	256
+
+asmlinkage void crc32_pmull_fold_neon(u8 *acc, const u8 *buf,
+				      unsigned int blocks, const u64 *k);
+
+/* bit reflected x^(512+32) mod P and x^(512-32) mod P, P = 0x1EDC6F41 */
+static const u64 crc32c_fold_consts[] = { 0x740eef02, 0x9e4addf8 };
+
+struct chksum_ctx {
+	u32 key;
+};
+
+struct chksum_desc_ctx {
+	u32 crc;
+};
+
+static u32 crc32c_neon(u32 crc, const u8 *data, unsigned int len)
+{
+	u8 acc[CRC32_FOLD_SIZE];
+	unsigned int blocks, done;
+
+	if (len < CRC32_NEON_MIN_LEN || !may_use_simd())
+		return __crc32c_le(crc, data, len);
+
+	/* the crc of the first block is that of the block xor'ed with it */
+	memcpy(acc, data, sizeof(acc));
+	put_unaligned_le32(get_unaligned_le32(acc) ^ crc, acc);
+
+	blocks = len / CRC32_FOLD_SIZE - 1;
+	kernel_neon_begin();
+	crc32_pmull_fold_neon(acc, data + CRC32_FOLD_SIZE, blocks,
+			      crc32c_fold_consts);
+	kernel_neon_end();
+
+	done = (blocks + 1) * CRC32_FOLD_SIZE;
+	crc = __crc32c_le(0, acc, sizeof(acc));
+	return __crc32c_le(crc, data + done, len - done);
+}
+
+static int crc32c_neon_init(struct shash_desc *desc)
+{
+	struct chksum_ctx *mctx = crypto_shash_ctx(desc->tfm);
+	struct chksum_desc_ctx *ctx = shash_desc_ctx(desc);
+
+	ctx->crc = mctx->key;
+
+	return 0;
+}
+
+static int crc32c_neon_setkey(struct crypto_shash *tfm, const u8 *key,
+			      unsigned int keylen)
+{
+	struct chksum_ctx *mctx = crypto_shash_ctx(tfm);
+
+	if (keylen != sizeof(mctx->key)) {
+		crypto_shash_set_flags(tfm, CRYPTO_TFM_RES_BAD_KEY_LEN);
+		return -EINVAL;
+	}
+	mctx->key = le32_to_cpu(*(__le32 *)key);
+	return 0;
+}
+
+static int crc32c_neon_update(struct shash_desc *desc, const u8 *data,
+			      unsigned int length)
+{
+	struct chksum_desc_ctx *ctx = shash_desc_ctx(desc);
+
+	ctx->crc = crc32c_neon(ctx->crc, data, length);
+	return 0;
+}
+
+static int crc32c_neon_final(struct shash_desc *desc, u8 *out)
+{
+	struct chksum_desc_ctx *ctx = shash_desc_ctx(desc);
+
+	*(__le32 *)out = ~cpu_to_le32p(&ctx->crc);
+	return 0;
+}
+
+static int __crc32c_neon_finup(u32 *crcp, const u8 *data, unsigned int len,
+			       u8 *out)
+{
+	*(__le32 *)out = ~cpu_to_le32(crc32c_neon(*crcp, data, len));
+	return 0;
+}
+
+static int crc32c_neon_finup(struct shash_desc *desc, const u8 *data,
+			     unsigned int len, u8 *out)
+{
+	struct chksum_desc_ctx *ctx = shash_desc_ctx(desc);
+
+	return __crc32c_neon_finup(&ctx->crc, data, len, out);
+}
+
+static int crc32c_neon_digest(struct shash_desc *desc, const u8 *data,
+			      unsigned int length, u8 *out)
+{
+	struct chksum_ctx *mctx = crypto_shash_ctx(desc->tfm);
+
+	return __crc32c_neon_finup(&mctx->key, data, length, out);
+}
+
+static int crc32c_neon_cra_init(struct crypto_tfm *tfm)
+{
+	struct chksum_ctx *mctx = crypto_tfm_ctx(tfm);
+
+	mctx->key = ~0;
+	return 0;
+}
+
+static struct shash_alg alg = {
+	.digestsize		=	CHKSUM_DIGEST_SIZE,
+	.setkey			=	crc32c_neon_setkey,
+	.init			=	crc32c_neon_init,
+	.update			=	crc32c_neon_update,
+	.final			=	crc32c_neon_final,
+	.finup			=	crc32c_neon_finup,
+	.digest			=	crc32c_neon_digest,
+	.descsize		=	sizeof(struct chksum_desc_ctx),
+	.base			=	{
+		.cra_name		=	"crc32c",
+		.cra_driver_name	=	"crc32c-neon",
+		.cra_priority		=	200,
+		.cra_flags		=	CRYPTO_ALG_TYPE_SHASH,
+		.cra_blocksize		=	CHKSUM_BLOCK_SIZE,
+		.cra_ctxsize		=	sizeof(struct chksum_ctx),
+		.cra_module		=	THIS_MODULE,
+		.cra_init		=	crc32c_neon_cra_init,
+	}
+};
+
+static int __init crc32c_neon_mod_init(void)
+{
+	if (!cpu_has_neon())
+		return -ENODEV;
+
+	return crypto_register_shash(&alg);
+}
+
+static void __exit crc32c_neon_mod_fini(void)
+{
+	crypto_unregister_shash(&alg);
+}
+
+module_init(crc32c_neon_mod_init);
+module_exit(crc32c_neon_mod_fini);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("CRC32c (Castagnoli), NEON accelerated");
+MODULE_ALIAS("crc32c");
@@ -0,0 +1,57 @@
+/*
+ * pmull-p8-neon.h - 64x64 bit carry-less multiply for ARMv7 NEON
+ *
+ * ARMv7 NEON only has an 8x8 bit carry-less multiply (vmull.p8), so the
+ * 64x64 bit product is assembled from eight of them, as in the NEON GHASH
+ * code of OpenSSL by Andy Polyakov. Shared by the CRC32 folding and GHASH
+ * code.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ */
+
+/*
+ * q8-q11 are scratch, d8-d10 hold the masks k48, k32 and k16.
+ * \rq (with halves \rl and \rh) = \ad * \bd, carry-less; \ad and \bd
+ * must not be part of \rq or of the scratch registers.
+ */
+	.macro	pmull_p8, rq, rl, rh, ad, bd
+	vext.8		d16, \ad, \ad, #1	@ A1
+	vmull.p8	q8, d16, \bd		@ F = A1*B
+	vext.8		\rl, \bd, \bd, #1	@ B1
+	vmull.p8	\rq, \ad, \rl		@ E = A*B1
+	vext.8		d18, \ad, \ad, #2	@ A2
+	vmull.p8	q9, d18, \bd		@ H = A2*B
+	vext.8		d22, \bd, \bd, #2	@ B2
+	vmull.p8	q11, \ad, d22		@ G = A*B2
+	vext.8		d20, \ad, \ad, #3	@ A3
+	veor		q8, q8, \rq		@ L = E + F
+	vmull.p8	q10, d20, \bd		@ J = A3*B
+	vext.8		\rl, \bd, \bd, #3	@ B3
+	veor		q9, q9, q11		@ M = G + H
+	vmull.p8	\rq, \ad, \rl		@ I = A*B3
+	veor		d16, d16, d17		@ t0 = (L) (P0 + P1) << 8
+	vand		d17, d17, d8
+	vext.8		d22, \bd, \bd, #4	@ B4
+	veor		d18, d18, d19		@ t1 = (M) (P2 + P3) << 16
+	vand		d19, d19, d9
+	vmull.p8	q11, \ad, d22		@ K = A*B4
+	veor		q10, q10, \rq		@ N = I + J
+	veor		d16, d16, d17
+	veor		d18, d18, d19
+	veor		d20, d20, d21		@ t2 = (N) (P4 + P5) << 24
+	vand		d21, d21, d10
+	vext.8		q8, q8, q8, #15
+	veor		d22, d22, d23		@ t3 = (K) (P6 + P7) << 32
+	vmov.i64	d23, #0
+	vext.8		q9, q9, q9, #14
+	veor		d20, d20, d21
+	vmull.p8	\rq, \ad, \bd		@ D = A*B
+	vext.8		q11, q11, q11, #12
+	vext.8		q10, q10, q10, #13
+	veor		q8, q8, q9
+	veor		q10, q10, q11
+	veor		\rq, \rq, q8
+	veor		\rq, \rq, q10
+	.endm
@@ -0,0 +1,176 @@
+/*
+ * Glue code for Poly1305 using the NEON code in poly1305-neon-core.S.
+ *
+ * The NEON code absorbs two blocks at a time and needs r^2, which is
+ * computed once per message here. Single blocks, the final block, short
+ * updates and updates issued where NEON can not be used go through the
+ * generic C code, which shares the accumulator format.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ */
+
+#include <crypto/algapi.h>
+#include <crypto/internal/hash.h>
+#include <crypto/poly1305.h>
+#include <linux/crypto.h>
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <asm/simd.h>
+#include <asm/neon.h>
+
+/* below this, saving and restoring the NEON state costs more than it saves */
+#define POLY1305_NEON_MIN_LEN	128
+
+asmlinkage void poly1305_2block_neon(u32 *h, const u8 *src, const u32 *r,
+				     unsigned int blocks, const u32 *u);
+
+struct poly1305_neon_desc_ctx {
+	struct poly1305_desc_ctx base;
+	/* derived key u set? */
+	bool uset;
+	/* derived key u = r^2 */
+	u32 u[5];
+};
+
+static int poly1305_neon_init(struct shash_desc *desc)
+{
+	struct poly1305_neon_desc_ctx *sctx = shash_desc_ctx(desc);
+
+	sctx->uset = false;
+
+	return crypto_poly1305_init(desc);
+}
+
+/* a = a * b mod 2^130 - 5, partially reduced as in the generic code */
+static void poly1305_neon_mult(u32 *a, const u32 *b)
+{
+	u32 s1 = b[1] * 5, s2 = b[2] * 5, s3 = b[3] * 5, s4 = b[4] * 5;
+	u64 d0, d1, d2, d3, d4;
+
+	d0 = (u64)a[0] * b[0] + (u64)a[1] * s4 + (u64)a[2] * s3 +
+	     (u64)a[3] * s2 + (u64)a[4] * s1;
+	d1 = (u64)a[0] * b[1] + (u64)a[1] * b[0] + (u64)a[2] * s4 +
+	     (u64)a[3] * s3 + (u64)a[4] * s2;
+	d2 = (u64)a[0] * b[2] + (u64)a[1] * b[1] + (u64)a[2] * b[0] +
+	     (u64)a[3] * s4 + (u64)a[4] * s3;
+	d3 = (u64)a[0] * b[3] + (u64)a[1] * b[2] + (u64)a[2] * b[1] +
+	     (u64)a[3] * b[0] + (u64)a[4] * s4;
+	d4 = (u64)a[0] * b[4] + (u64)a[1] * b[3] + (u64)a[2] * b[2] +
+	     (u64)a[3] * b[1] + (u64)a[4] * b[0];
+
+	d1 += d0 >> 26;                 a[0] = d0 & 0x3ffffff;
+	d2 += d1 >> 26;                 a[1] = d1 & 0x3ffffff;
+	d3 += d2 >> 26;                 a[2] = d2 & 0x3ffffff;
+	d4 += d3 >> 26;                 a[3] = d3 & 0x3ffffff;
+	a[0] += (u32)(d4 >> 26) * 5;    a[4] = d4 & 0x3ffffff;
+	a[1] += a[0] >> 26;             a[0] &= 0x3ffffff;
+}
+
+static unsigned int poly1305_neon_blocks(struct poly1305_neon_desc_ctx *sctx,
+					 const u8 *src, unsigned int srclen)
+{
+	struct poly1305_desc_ctx *dctx = &sctx->base;
+	unsigned int datalen, blocks;
+
+	if (unlikely(!dctx->sset)) {
+		datalen = crypto_poly1305_setdesckey(dctx, src, srclen);
+		src += srclen - datalen;
+		srclen = datalen;
+	}
+
+	if (srclen >= POLY1305_BLOCK_SIZE * 2) {
+		if (unlikely(!sctx->uset)) {
+			memcpy(sctx->u, dctx->r, sizeof(sctx->u));
+			poly1305_neon_mult(sctx->u, dctx->r);
+			sctx->uset = true;
+		}
+		blocks = srclen / (POLY1305_BLOCK_SIZE * 2);
+		poly1305_2block_neon(dctx->h, src, dctx->r, blocks, sctx->u);
+		src += POLY1305_BLOCK_SIZE * 2 * blocks;
+		srclen -= POLY1305_BLOCK_SIZE * 2 * blocks;
+	}
+
+	return crypto_poly1305_blocks(dctx, src, srclen);
+}
+
+static int poly1305_neon_update(struct shash_desc *desc,
+				const u8 *src, unsigned int srclen)
+{
+	struct poly1305_neon_desc_ctx *sctx = shash_desc_ctx(desc);
+	struct poly1305_desc_ctx *dctx = &sctx->base;
+	unsigned int bytes;
+
+	if (srclen < POLY1305_NEON_MIN_LEN || !may_use_simd())
+		return crypto_poly1305_update(desc, src, srclen);
+
+	kernel_neon_begin();
+
+	if (unlikely(dctx->buflen)) {
+		bytes = min(srclen, POLY1305_BLOCK_SIZE - dctx->buflen);
+		memcpy(dctx->buf + dctx->buflen, src, bytes);
+		src += bytes;
+		srclen -= bytes;
+		dctx->buflen += bytes;
+
+		if (dctx->buflen == POLY1305_BLOCK_SIZE) {
+			poly1305_neon_blocks(sctx, dctx->buf,
+					     POLY1305_BLOCK_SIZE);
+			dctx->buflen = 0;
+		}
+	}
+
+	if (likely(srclen >= POLY1305_BLOCK_SIZE)) {
+		bytes = poly1305_neon_blocks(sctx, src, srclen);
+		src += srclen - bytes;
+		srclen = bytes;
+	}
+
+	kernel_neon_end();
+
+	if (unlikely(srclen)) {
+		dctx->buflen = srclen;
+		memcpy(dctx->buf, src, srclen);
+	}
+
+	return 0;
+}
+
+static struct shash_alg alg = {
+	.digestsize	= POLY1305_DIGEST_SIZE,
+	.init		= poly1305_neon_init,
+	.update		= poly1305_neon_update,
+	.final		= crypto_poly1305_final,
+	.setkey		= crypto_poly1305_setkey,
+	.descsize	= sizeof(struct poly1305_neon_desc_ctx),
+	.base		= {
+		.cra_name		= "poly1305",
+		.cra_driver_name	= "poly1305-neon",
+		.cra_priority		= 200,
+		.cra_flags		= CRYPTO_ALG_TYPE_SHASH,
+		.cra_alignmask		= sizeof(u32) - 1,
+		.cra_blocksize		= POLY1305_BLOCK_SIZE,
+		.cra_module		= THIS_MODULE,
+	},
+};
+
+static int __init poly1305_neon_mod_init(void)
+{
+	if (!cpu_has_neon())
+		return -ENODEV;
+
+	return crypto_register_shash(&alg);
+}
+
+static void __exit poly1305_neon_mod_exit(void)
+{
+	crypto_unregister_shash(&alg);
+}
+
+module_init(poly1305_neon_mod_init);
+module_exit(poly1305_neon_mod_exit);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("Poly1305 authenticator, NEON accelerated");
+MODULE_ALIAS("poly1305");
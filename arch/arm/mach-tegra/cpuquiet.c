@@ -68,6 +68,8 @@ static wait_queue_head_t wait_cpu;
 static int no_lp;
 static bool screen_off_lp;
 static bool enable;
+/* quiesce G cores with cpu_park() instead of cpu_down() */
+static bool park;
 static unsigned long up_delay;
 static unsigned long down_delay;
 static unsigned long hotplug_timeout;
@@ -162,6 +164,75 @@ static void hp_stats_update(unsigned int cpu, bool up)
 	mutex_unlock(&tegra_cpq_lock_stats);
 }
 
+enum {
+	HP_LAT_UP = 0,
+	HP_LAT_DOWN,
+	HP_LAT_UNPARK,
+	HP_LAT_PARK,
+	HP_LAT_NR,
+};
+
+static struct {
+	unsigned int count;
+	u64 total_us;
+	u64 max_us;
+} hp_latency[HP_LAT_NR];
+
+static void hp_latency_update(int path, ktime_t start)
+{
+	u64 us = ktime_to_us(ktime_sub(ktime_get(), start));
+
+	mutex_lock(&tegra_cpq_lock_stats);
+	hp_latency[path].count++;
+	hp_latency[path].total_us += us;
+	if (us > hp_latency[path].max_us)
+		hp_latency[path].max_us = us;
+	mutex_unlock(&tegra_cpq_lock_stats);
+}
+
+/* Bring @cpu back into scheduling, from parked or offline */
+static void tegra_cpq_up(unsigned int cpu)
+{
+	ktime_t start = ktime_get();
+
+	if (cpu_online(cpu)) {
+		if (!cpu_unpark(cpu))
+			hp_latency_update(HP_LAT_UNPARK, start);
+	} else {
+		if (!cpu_up(cpu))
+			hp_latency_update(HP_LAT_UP, start);
+	}
+	hp_stats_update(cpu, true);
+}
+
+/* Take @cpu out of scheduling, parking it if requested */
+static void tegra_cpq_down(unsigned int cpu)
+{
+	ktime_t start = ktime_get();
+
+	if (park) {
+		if (!cpu_active(cpu))
+			return;
+		if (!cpu_park(cpu))
+			hp_latency_update(HP_LAT_PARK, start);
+	} else {
+		if (!cpu_down(cpu))
+			hp_latency_update(HP_LAT_DOWN, start);
+	}
+	hp_stats_update(cpu, false);
+}
+
+/* Parked cores are still online, fully offline them */
+static void tegra_cpq_down_parked(void)
+{
+	unsigned int cpu;
+
+	for_each_online_cpu(cpu) {
+		if (!cpu_active(cpu))
+			cpu_down(cpu);
+	}
+}
+
 #ifdef CONFIG_MACH_X3
 /* Use display state to try and save some power. From earlysuspend.c */
 extern bool wants_display_on;
@@ -172,7 +243,7 @@ static void __update_target_cluster(unsigned int cpu_freq, bool suspend)
 {
 	int min_cpus = pm_qos_request(PM_QOS_MIN_ONLINE_CPUS);
 
-	if (num_online_cpus() > 1) {
+	if (num_active_cpus() > 1) {
 		cpq_target_cluster_state = TEGRA_CPQ_G;
 		del_timer(&updown_timer);
 
@@ -297,7 +368,7 @@ static int tegra_quiesence_cpu(unsigned int cpunumber, bool sync)
 		return err;
 
 	err = wait_event_interruptible_timeout(wait_cpu,
-					      !cpu_online(cpunumber),
+					      !cpu_active(cpunumber),
 					      hotplug_timeout);
 
 	if (err < 0)
@@ -317,7 +388,7 @@ static int tegra_wake_cpu(unsigned int cpunumber, bool sync)
 	if (err || !sync)
 		return err;
 
-	err = wait_event_interruptible_timeout(wait_cpu, cpu_online(cpunumber),
+	err = wait_event_interruptible_timeout(wait_cpu, cpu_active(cpunumber),
 					      hotplug_timeout);
 
 	if (err < 0)
@@ -391,7 +462,7 @@ static void __cpuinit __apply_core_config(void)
 	int count = -1;
 	unsigned int cpu;
 	int nr_cpus;
-	struct cpumask online, offline, cpu_online;
+	struct cpumask online, offline, cpu_active;
 	int max_cpus = pm_qos_request(PM_QOS_MAX_ONLINE_CPUS);
 	int min_cpus = pm_qos_request(PM_QOS_MIN_ONLINE_CPUS);
 	
@@ -409,7 +480,7 @@ static void __cpuinit __apply_core_config(void)
 
 	/* always keep CPU0 online */
 	cpumask_set_cpu(0, &online);
-	cpu_online = *cpu_online_mask;
+	cpu_active = *cpu_active_mask;
 
 	if (no_lp == -1) {
 	max_cpus = 1;
@@ -437,17 +508,14 @@ static void __cpuinit __apply_core_config(void)
 		}
 	}
 
-	cpumask_andnot(&online, &online, &cpu_online);
-	for_each_cpu(cpu, &online) {
-		cpu_up(cpu);
-		hp_stats_update(cpu, true);
-	}
+	cpumask_andnot(&online, &online, &cpu_active);
+	for_each_cpu(cpu, &online)
+		tegra_cpq_up(cpu);
 
-	cpumask_and(&offline, &offline, &cpu_online);
-	for_each_cpu(cpu, &offline) {
-		cpu_down(cpu);
-		hp_stats_update(cpu, false);
-	}
+	/* parked cores are offlined as well once parking is turned off */
+	cpumask_and(&offline, &offline, park ? &cpu_active : cpu_online_mask);
+	for_each_cpu(cpu, &offline)
+		tegra_cpq_down(cpu);
 	wake_up_interruptible(&wait_cpu);
 }
 
@@ -488,6 +556,9 @@ static void __cpuinit tegra_cpuquiet_work_func(struct work_struct *work)
 
 	mutex_unlock(tegra_cpu_lock);
 	if (current_cluster != new_cluster) {
+		if (new_cluster == TEGRA_CPQ_LP)
+			tegra_cpq_down_parked();
+
 		current_cluster = __apply_cluster_config(current_cluster,
 					new_cluster);
 
@@ -568,10 +639,10 @@ void tegra_auto_hotplug_governor(unsigned int cpu_freq, bool suspend)
 	}
 
 	/*
-	 * If there is more then 1 CPU online, we must be on the fast cluster
+	 * If there is more then 1 CPU active, we must be on the fast cluster
 	 * and we can't switch.
 	 */
-	if (num_online_cpus() > 1)
+	if (num_active_cpus() > 1)
 		return;
 	__update_target_cluster(cpu_freq, suspend);
 }
@@ -661,6 +732,7 @@ CPQ_ATTRIBUTE(down_delay, 0644, ulong, delay_callback);
 CPQ_ATTRIBUTE(hotplug_timeout, 0644, ulong, delay_callback);
 CPQ_ATTRIBUTE(enable, 0644, bool, enable_callback);
 CPQ_BASIC_ATTRIBUTE(screen_off_lp, 0644, bool);
+CPQ_BASIC_ATTRIBUTE(park, 0644, bool);
 
 static struct attribute *tegra_auto_attributes[] = {
 	&no_lp_attr.attr,
@@ -671,6 +743,7 @@ static struct attribute *tegra_auto_attributes[] = {
 	&enable_attr.attr,
 	&hotplug_timeout_attr.attr,
 	&screen_off_lp_attr.attr,
+	&park_attr.attr,
 	NULL,
 };
 
@@ -763,6 +836,44 @@ static const struct file_operations hp_stats_fops = {
 	.release	= single_release,
 };
 
+static const char * const hp_lat_names[HP_LAT_NR] = {
+	"up", "down", "unpark", "park",
+};
+
+static int hp_latency_show(struct seq_file *s, void *data)
+{
+	int i;
+
+	seq_printf(s, "%-8s %10s %12s %10s %10s\n",
+		   "path", "count", "total_us", "avg_us", "max_us");
+
+	mutex_lock(&tegra_cpq_lock_stats);
+	for (i = 0; i < HP_LAT_NR; i++) {
+		u64 avg = hp_latency[i].total_us;
+
+		if (hp_latency[i].count)
+			do_div(avg, hp_latency[i].count);
+		seq_printf(s, "%-8s %10u %12llu %10llu %10llu\n",
+			   hp_lat_names[i], hp_latency[i].count,
+			   hp_latency[i].total_us, avg, hp_latency[i].max_us);
+	}
+	mutex_unlock(&tegra_cpq_lock_stats);
+
+	return 0;
+}
+
+static int hp_latency_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, hp_latency_show, inode->i_private);
+}
+
+static const struct file_operations hp_latency_fops = {
+	.open		= hp_latency_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
 
 struct pm_qos_request min_cpu_req;
 struct pm_qos_request max_cpu_req;
@@ -815,6 +926,10 @@ static int __init tegra_cpuquiet_debug_init(void)
 		"stats", S_IRUGO, hp_debugfs_root, NULL, &hp_stats_fops))
 		goto err_out;
 
+	if (!debugfs_create_file(
+		"latency", S_IRUGO, hp_debugfs_root, NULL, &hp_latency_fops))
+		goto err_out;
+
 	return 0;
 
 err_out:
@@ -28,6 +28,7 @@
 #include <linux/gfp.h>
 #include <linux/module.h>
 #include <linux/scatterlist.h>
+#include <linux/slab.h>
 #include <linux/string.h>
 #include <linux/moduleparam.h>
 #include <linux/jiffies.h>
@@ -64,7 +65,7 @@ static char *check[] = {
 	"cast6", "arc4", "michael_mic", "deflate", "crc32c", "tea", "xtea",
 	"khazad", "wp512", "wp384", "wp256", "tnepres", "xeta",  "fcrypt",
 	"camellia", "seed", "salsa20", "rmd128", "rmd160", "rmd256", "rmd320",
-	"lzo", "cts", "zlib", NULL
+	"lzo", "cts", "zlib", "lz4", "lz4hc", "chacha20", "poly1305", NULL
 };
 
 static int test_cipher_jiffies(struct blkcipher_desc *desc, int enc,
@@ -475,6 +476,142 @@ out:
 	crypto_free_hash(tfm);
 }
 
+static int test_comp_jiffies(struct crypto_comp *tfm, const u8 *in, int blen,
+			     u8 *cbuf, u8 *dbuf, int sec)
+{
+	unsigned long start, end;
+	unsigned int clen, dlen;
+	int ccount, dcount;
+	int ret;
+
+	for (start = jiffies, end = start + sec * HZ, ccount = 0;
+	     time_before(jiffies, end); ccount++) {
+		clen = 2 * PAGE_SIZE;
+		ret = crypto_comp_compress(tfm, in, blen, cbuf, &clen);
+		if (ret)
+			return ret;
+	}
+
+	for (start = jiffies, end = start + sec * HZ, dcount = 0;
+	     time_before(jiffies, end); dcount++) {
+		dlen = PAGE_SIZE;
+		ret = crypto_comp_decompress(tfm, cbuf, clen, dbuf, &dlen);
+		if (ret)
+			return ret;
+	}
+
+	printk("%5u bytes out, comp %9lu bytes/sec, decomp %9lu bytes/sec\n",
+	       clen, ((long)ccount * blen) / sec, ((long)dcount * blen) / sec);
+
+	return 0;
+}
+
+static int test_comp_cycles(struct crypto_comp *tfm, const u8 *in, int blen,
+			    u8 *cbuf, u8 *dbuf)
+{
+	unsigned long ccycles = 0, dcycles = 0;
+	unsigned int clen = 0, dlen;
+	int i;
+	int ret = 0;
+
+	local_bh_disable();
+	local_irq_disable();
+
+	/* Warm-up run, then the real thing. */
+	for (i = 0; i < 12; i++) {
+		cycles_t start, mid, end;
+
+		start = get_cycles();
+
+		clen = 2 * PAGE_SIZE;
+		ret = crypto_comp_compress(tfm, in, blen, cbuf, &clen);
+		if (ret)
+			goto out;
+
+		mid = get_cycles();
+
+		dlen = PAGE_SIZE;
+		ret = crypto_comp_decompress(tfm, cbuf, clen, dbuf, &dlen);
+		if (ret)
+			goto out;
+
+		end = get_cycles();
+
+		if (i >= 4) {
+			ccycles += mid - start;
+			dcycles += end - mid;
+		}
+	}
+
+out:
+	local_irq_enable();
+	local_bh_enable();
+
+	if (ret)
+		return ret;
+
+	printk("%5u bytes out, comp %4lu cycles/byte, decomp %4lu cycles/byte\n",
+	       clen, ccycles / (8 * blen), dcycles / (8 * blen));
+
+	return 0;
+}
+
+static void test_comp_speed(const char *algo, unsigned int sec,
+			    unsigned int *blens)
+{
+	static const char text[] = "Pages written to these disks are "
+		"compressed and stored in memory itself. ";
+	struct crypto_comp *tfm;
+	u8 *in = tvmem[0];
+	u8 *cbuf = NULL, *dbuf = tvmem[1];
+	int i;
+	int ret;
+
+	printk(KERN_INFO "\ntesting speed of %s\n", algo);
+
+	tfm = crypto_alloc_comp(algo, 0, 0);
+	if (IS_ERR(tfm)) {
+		printk(KERN_ERR "failed to load transform for %s: %ld\n", algo,
+		       PTR_ERR(tfm));
+		return;
+	}
+
+	cbuf = kmalloc(2 * PAGE_SIZE, GFP_KERNEL);
+	if (!cbuf) {
+		printk(KERN_ERR "tcrypt: failed to allocate output buffer\n");
+		goto out;
+	}
+
+	/* text with a counter mixed in, roughly as compressible as a page */
+	for (i = 0; i < PAGE_SIZE; i++)
+		in[i] = i % 61 ? text[i % (sizeof(text) - 1)] : (u8)(i / 61);
+
+	for (i = 0; blens[i] != 0; i++) {
+		if (blens[i] > PAGE_SIZE) {
+			printk(KERN_ERR "template (%u) too big for tvmem (%lu)\n",
+			       blens[i], PAGE_SIZE);
+			break;
+		}
+
+		printk(KERN_INFO "test %u (%5u byte blocks): ", i, blens[i]);
+
+		if (sec)
+			ret = test_comp_jiffies(tfm, in, blens[i], cbuf, dbuf,
+						sec);
+		else
+			ret = test_comp_cycles(tfm, in, blens[i], cbuf, dbuf);
+
+		if (ret) {
+			printk(KERN_ERR "compression failed ret=%d\n", ret);
+			break;
+		}
+	}
+
+out:
+	kfree(cbuf);
+	crypto_free_comp(tfm);
+}
+
 struct tcrypt_result {
 	struct completion completion;
 	int err;
@@ -719,6 +856,197 @@ out:
 	crypto_free_ahash(tfm);
 }
 
+/* room for the largest of block_sizes plus the authentication tag */
+#define AEAD_BUF_SIZE	(8192 + 16)
+
+/* associated data of an ESP packet: SPI and sequence number */
+#define AEAD_ASSOC_LEN	8
+
+static inline int do_one_aead_op(struct aead_request *req, int ret)
+{
+	if (ret == -EINPROGRESS || ret == -EBUSY) {
+		struct tcrypt_result *tr = req->base.data;
+
+		ret = wait_for_completion_interruptible(&tr->completion);
+		if (!ret)
+			ret = tr->err;
+		INIT_COMPLETION(tr->completion);
+	}
+	return ret;
+}
+
+static int test_aead_jiffies(struct aead_request *req, int enc, int blen,
+			     int sec)
+{
+	unsigned long start, end;
+	int bcount;
+	int ret;
+
+	for (start = jiffies, end = start + sec * HZ, bcount = 0;
+	     time_before(jiffies, end); bcount++) {
+		if (enc)
+			ret = do_one_aead_op(req, crypto_aead_encrypt(req));
+		else
+			ret = do_one_aead_op(req, crypto_aead_decrypt(req));
+
+		if (ret)
+			return ret;
+	}
+
+	printk("%d operations in %d seconds (%ld bytes)\n",
+	       bcount, sec, (long)bcount * blen);
+	return 0;
+}
+
+static int test_aead_cycles(struct aead_request *req, int enc, int blen)
+{
+	unsigned long cycles = 0;
+	int ret = 0;
+	int i;
+
+	/* Warm-up run. */
+	for (i = 0; i < 4; i++) {
+		if (enc)
+			ret = do_one_aead_op(req, crypto_aead_encrypt(req));
+		else
+			ret = do_one_aead_op(req, crypto_aead_decrypt(req));
+
+		if (ret)
+			goto out;
+	}
+
+	/* The real thing. */
+	for (i = 0; i < 8; i++) {
+		cycles_t start, end;
+
+		start = get_cycles();
+		if (enc)
+			ret = do_one_aead_op(req, crypto_aead_encrypt(req));
+		else
+			ret = do_one_aead_op(req, crypto_aead_decrypt(req));
+		end = get_cycles();
+
+		if (ret)
+			goto out;
+
+		cycles += end - start;
+	}
+
+out:
+	if (ret == 0)
+		printk("1 operation in %lu cycles (%d bytes)\n",
+		       (cycles + 4) / 8, blen);
+
+	return ret;
+}
+
+static void test_aead_speed(const char *algo, int enc, unsigned int sec,
+			    unsigned int authsize, u8 *keysize)
+{
+	struct scatterlist asg, sg, dsg;
+	struct tcrypt_result tresult;
+	struct aead_request *req;
+	struct crypto_aead *tfm;
+	u8 *assoc, *src, *dst;
+	unsigned int i;
+	int ret;
+	const char *e;
+	char iv[128];
+	u32 *b_size;
+
+	if (enc == ENCRYPT)
+		e = "encryption";
+	else
+		e = "decryption";
+
+	printk(KERN_INFO "\ntesting speed of %s %s\n", algo, e);
+
+	tfm = crypto_alloc_aead(algo, 0, 0);
+	if (IS_ERR(tfm)) {
+		pr_err("failed to load transform for %s: %ld\n", algo,
+		       PTR_ERR(tfm));
+		return;
+	}
+
+	ret = crypto_aead_setauthsize(tfm, authsize);
+	if (ret) {
+		pr_err("authsize %u not supported by %s\n", authsize, algo);
+		goto out;
+	}
+
+	assoc = kzalloc(AEAD_ASSOC_LEN, GFP_KERNEL);
+	src = kmalloc(AEAD_BUF_SIZE, GFP_KERNEL);
+	dst = kmalloc(AEAD_BUF_SIZE, GFP_KERNEL);
+	req = aead_request_alloc(tfm, GFP_KERNEL);
+	if (!assoc || !src || !dst || !req) {
+		pr_err("aead request allocation failure\n");
+		goto out_free;
+	}
+
+	init_completion(&tresult.completion);
+	aead_request_set_callback(req, CRYPTO_TFM_REQ_MAY_BACKLOG,
+				  tcrypt_complete, &tresult);
+
+	memset(iv, 0xff, crypto_aead_ivsize(tfm));
+	memset(src, 0xff, AEAD_BUF_SIZE);
+	sg_init_one(&asg, assoc, AEAD_ASSOC_LEN);
+
+	i = 0;
+	do {
+		memset(tvmem[0], 0xff, PAGE_SIZE);
+		ret = crypto_aead_setkey(tfm, tvmem[0], *keysize);
+		if (ret) {
+			pr_err("setkey() failed flags=%x\n",
+			       crypto_aead_get_flags(tfm));
+			goto out_free;
+		}
+
+		b_size = block_sizes;
+		do {
+			printk("test %u (%d bit key, %d byte blocks): ",
+			       i, *keysize * 8, *b_size);
+
+			sg_init_one(&sg, src, *b_size + authsize);
+			sg_init_one(&dsg, dst, *b_size + authsize);
+			aead_request_set_assoc(req, &asg, AEAD_ASSOC_LEN);
+			aead_request_set_crypt(req, &sg, &dsg, *b_size, iv);
+
+			/* decrypt a valid message, so the tag checks out */
+			if (enc == DECRYPT) {
+				ret = do_one_aead_op(req,
+						     crypto_aead_encrypt(req));
+				if (ret) {
+					pr_err("encrypt failed ret=%d\n", ret);
+					goto out_free;
+				}
+				aead_request_set_crypt(req, &dsg, &sg,
+						       *b_size + authsize, iv);
+			}
+
+			if (sec)
+				ret = test_aead_jiffies(req, enc, *b_size, sec);
+			else
+				ret = test_aead_cycles(req, enc, *b_size);
+
+			if (ret) {
+				pr_err("%s() failed ret=%d\n", e, ret);
+				goto out_free;
+			}
+			b_size++;
+			i++;
+		} while (*b_size);
+		keysize++;
+	} while (*keysize);
+
+out_free:
+	aead_request_free(req);
+	kfree(dst);
+	kfree(src);
+	kfree(assoc);
+out:
+	crypto_free_aead(tfm);
+}
+
 static void test_available(void)
 {
 	char **name = check;
@@ -948,6 +1276,30 @@ static int do_test(int m)
 		ret += tcrypt_test("ofb(aes)");
 		break;
 
+	case 47:
+		ret += tcrypt_test("lz4");
+		break;
+
+	case 48:
+		ret += tcrypt_test("lz4hc");
+		break;
+
+	case 49:
+		ret += tcrypt_test("chacha20");
+		break;
+
+	case 50:
+		ret += tcrypt_test("poly1305");
+		break;
+
+	case 51:
+		ret += tcrypt_test("rfc7539(chacha20,poly1305)");
+		break;
+
+	case 52:
+		ret += tcrypt_test("rfc7539esp(chacha20,poly1305)");
+		break;
+
 	case 100:
 		ret += tcrypt_test("hmac(md5)");
 		break;
@@ -1087,6 +1439,39 @@ static int do_test(int m)
 				  speed_template_16_32);
 		break;
 
+	case 207:
+		test_cipher_speed("chacha20", ENCRYPT, sec, NULL, 0,
+				  speed_template_32);
+		break;
+
+	case 210:
+		test_aead_speed("rfc4106(gcm(aes))", ENCRYPT, sec, 16,
+				speed_template_20);
+		test_aead_speed("rfc4106(gcm(aes))", DECRYPT, sec, 16,
+				speed_template_20);
+		break;
+
+	case 211:
+		test_aead_speed("gcm(aes)", ENCRYPT, sec, 16,
+				speed_template_16_24_32);
+		test_aead_speed("gcm(aes)", DECRYPT, sec, 16,
+				speed_template_16_24_32);
+		break;
+
+	case 212:
+		test_aead_speed("rfc7539(chacha20,poly1305)", ENCRYPT, sec, 16,
+				speed_template_32);
+		test_aead_speed("rfc7539(chacha20,poly1305)", DECRYPT, sec, 16,
+				speed_template_32);
+		break;
+
+	case 213:
+		test_aead_speed("rfc7539esp(chacha20,poly1305)", ENCRYPT, sec,
+				16, speed_template_36);
+		test_aead_speed("rfc7539esp(chacha20,poly1305)", DECRYPT, sec,
+				16, speed_template_36);
+		break;
+
 	case 300:
 		/* fall through */
 
@@ -1162,6 +1547,14 @@ static int do_test(int m)
 		test_hash_speed("ghash-generic", sec, hash_speed_template_16);
 		if (mode > 300 && mode < 400) break;
 
+	case 319:
+		test_hash_speed("crc32c", sec, generic_hash_speed_template);
+		if (mode > 300 && mode < 400) break;
+
+	case 320:
+		test_hash_speed("poly1305", sec, poly1305_speed_template);
+		if (mode > 300 && mode < 400) break;
+
 	case 399:
 		break;
 
@@ -1236,9 +1629,31 @@ static int do_test(int m)
 		test_ahash_speed("rmd320", sec, generic_hash_speed_template);
 		if (mode > 400 && mode < 500) break;
 
+	case 418:
+		test_ahash_speed("ghash", sec, hash_speed_template_16);
+		if (mode > 400 && mode < 500) break;
+
 	case 499:
 		break;
 
+	case 500:
+		/* fall through */
+
+	case 501:
+		test_comp_speed("lzo", sec, comp_speed_template);
+		if (mode > 500 && mode < 600) break;
+
+	case 502:
+		test_comp_speed("lz4", sec, comp_speed_template);
+		if (mode > 500 && mode < 600) break;
+
+	case 503:
+		test_comp_speed("lz4hc", sec, comp_speed_template);
+		if (mode > 500 && mode < 600) break;
+
+	case 599:
+		break;
+
 	case 1000:
 		test_available();
 		break;
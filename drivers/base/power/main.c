@@ -29,6 +29,8 @@
 #include <linux/async.h>
 #include <linux/suspend.h>
 #include <linux/timer.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
 
 #include "../base.h"
 #include "power.h"
@@ -407,6 +409,202 @@ static void pm_dev_err(struct device *dev, pm_message_t state, char *info,
 		dev_name(dev), pm_verb(state.event), info, error);
 }
 
+/*------------------------- Suspend/resume timing -------------------------*/
+
+enum dpm_phase {
+	DPM_PHASE_PREPARE,
+	DPM_PHASE_SUSPEND,
+	DPM_PHASE_SUSPEND_NOIRQ,
+	DPM_PHASE_RESUME_NOIRQ,
+	DPM_PHASE_RESUME,
+	DPM_PHASE_COMPLETE,
+	DPM_PHASE_COUNT
+};
+
+#ifdef CONFIG_DEBUG_FS
+
+/*
+ * Keep the phase durations and the slowest device callbacks of each phase
+ * for the last DPM_TIMING_CYCLES system transitions, for debugfs.
+ */
+#define DPM_TIMING_CYCLES	8
+#define DPM_TIMING_SLOWEST	6
+#define DPM_TIMING_NAME_LEN	32
+
+struct dpm_dev_time {
+	char name[DPM_TIMING_NAME_LEN];
+	s64 usecs;
+	int error;
+};
+
+struct dpm_phase_time {
+	s64 usecs;
+	s64 dev_usecs;		/* sum of callbacks, i.e. the sequential time */
+	unsigned int nr_devs;
+	unsigned int nr_async;
+	struct dpm_dev_time slowest[DPM_TIMING_SLOWEST];
+};
+
+struct dpm_cycle_time {
+	int event;
+	struct timespec start;
+	struct dpm_phase_time phase[DPM_PHASE_COUNT];
+};
+
+static struct dpm_cycle_time dpm_cycles[DPM_TIMING_CYCLES];
+static unsigned int dpm_nr_cycles;
+static DEFINE_SPINLOCK(dpm_timing_lock);
+
+static const char * const dpm_phase_names[DPM_PHASE_COUNT] = {
+	[DPM_PHASE_PREPARE]		= "prepare",
+	[DPM_PHASE_SUSPEND]		= "suspend",
+	[DPM_PHASE_SUSPEND_NOIRQ]	= "suspend_noirq",
+	[DPM_PHASE_RESUME_NOIRQ]	= "resume_noirq",
+	[DPM_PHASE_RESUME]		= "resume",
+	[DPM_PHASE_COMPLETE]		= "complete",
+};
+
+static struct dpm_cycle_time *dpm_cycle_cur(void)
+{
+	if (!dpm_nr_cycles)
+		return NULL;
+	return &dpm_cycles[(dpm_nr_cycles - 1) % DPM_TIMING_CYCLES];
+}
+
+static void dpm_timing_start_cycle(pm_message_t state)
+{
+	struct dpm_cycle_time *cycle;
+	unsigned long flags;
+
+	spin_lock_irqsave(&dpm_timing_lock, flags);
+	cycle = &dpm_cycles[dpm_nr_cycles++ % DPM_TIMING_CYCLES];
+	memset(cycle, 0, sizeof(*cycle));
+	cycle->event = state.event;
+	getnstimeofday(&cycle->start);
+	spin_unlock_irqrestore(&dpm_timing_lock, flags);
+}
+
+static void dpm_timing_phase(enum dpm_phase phase, ktime_t starttime)
+{
+	s64 usecs = ktime_us_delta(ktime_get(), starttime);
+	struct dpm_cycle_time *cycle;
+	unsigned long flags;
+
+	spin_lock_irqsave(&dpm_timing_lock, flags);
+	cycle = dpm_cycle_cur();
+	if (cycle)
+		cycle->phase[phase].usecs = usecs;
+	spin_unlock_irqrestore(&dpm_timing_lock, flags);
+}
+
+static void dpm_timing_dev(struct device *dev, enum dpm_phase phase,
+			   ktime_t calltime, int error, bool async)
+{
+	s64 usecs = ktime_us_delta(ktime_get(), calltime);
+	struct dpm_cycle_time *cycle;
+	struct dpm_phase_time *pt;
+	unsigned long flags;
+	int i;
+
+	spin_lock_irqsave(&dpm_timing_lock, flags);
+	cycle = dpm_cycle_cur();
+	if (!cycle)
+		goto out;
+
+	pt = &cycle->phase[phase];
+	pt->nr_devs++;
+	pt->dev_usecs += usecs;
+	if (async)
+		pt->nr_async++;
+
+	/* slowest[] is sorted, longest first */
+	for (i = DPM_TIMING_SLOWEST; i > 0 && usecs > pt->slowest[i - 1].usecs;
+	     i--)
+		if (i < DPM_TIMING_SLOWEST)
+			pt->slowest[i] = pt->slowest[i - 1];
+	if (i < DPM_TIMING_SLOWEST) {
+		strlcpy(pt->slowest[i].name, dev_name(dev),
+			DPM_TIMING_NAME_LEN);
+		pt->slowest[i].usecs = usecs;
+		pt->slowest[i].error = error;
+	}
+ out:
+	spin_unlock_irqrestore(&dpm_timing_lock, flags);
+}
+
+static int dpm_timing_show(struct seq_file *m, void *unused)
+{
+	struct dpm_cycle_time *cycle;
+	struct dpm_phase_time *pt;
+	unsigned long flags;
+	unsigned int n;
+	int p, i;
+
+	spin_lock_irqsave(&dpm_timing_lock, flags);
+	n = dpm_nr_cycles > DPM_TIMING_CYCLES ?
+		dpm_nr_cycles - DPM_TIMING_CYCLES : 0;
+	for (; n < dpm_nr_cycles; n++) {
+		cycle = &dpm_cycles[n % DPM_TIMING_CYCLES];
+		seq_printf(m, "cycle %u: %s at %ld.%09ld\n", n,
+			   pm_verb(cycle->event), cycle->start.tv_sec,
+			   cycle->start.tv_nsec);
+		for (p = 0; p < DPM_PHASE_COUNT; p++) {
+			pt = &cycle->phase[p];
+			if (!pt->nr_devs)
+				continue;
+			seq_printf(m, "  %-14s %10lld us  %u devices  "
+				   "%u async  %lld us sequential\n",
+				   dpm_phase_names[p], pt->usecs, pt->nr_devs,
+				   pt->nr_async, pt->dev_usecs);
+			for (i = 0; i < DPM_TIMING_SLOWEST; i++) {
+				if (!pt->slowest[i].name[0])
+					break;
+				seq_printf(m, "    %-32s %10lld us",
+					   pt->slowest[i].name,
+					   pt->slowest[i].usecs);
+				if (pt->slowest[i].error)
+					seq_printf(m, "  error %d",
+						   pt->slowest[i].error);
+				seq_putc(m, '\n');
+			}
+		}
+	}
+	spin_unlock_irqrestore(&dpm_timing_lock, flags);
+
+	return 0;
+}
+
+static int dpm_timing_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, dpm_timing_show, NULL);
+}
+
+static const struct file_operations dpm_timing_fops = {
+	.owner = THIS_MODULE,
+	.open = dpm_timing_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init dpm_timing_debugfs_init(void)
+{
+	debugfs_create_file("suspend_timing", S_IRUGO, NULL, NULL,
+			    &dpm_timing_fops);
+	return 0;
+}
+late_initcall(dpm_timing_debugfs_init);
+
+#else /* !CONFIG_DEBUG_FS */
+
+static inline void dpm_timing_start_cycle(pm_message_t state) {}
+static inline void dpm_timing_phase(enum dpm_phase phase,
+				    ktime_t starttime) {}
+static inline void dpm_timing_dev(struct device *dev, enum dpm_phase phase,
+				  ktime_t calltime, int error, bool async) {}
+
+#endif /* !CONFIG_DEBUG_FS */
+
 static void dpm_show_time(ktime_t starttime, pm_message_t state, char *info)
 {
 	ktime_t calltime;
@@ -475,11 +673,15 @@ void dpm_resume_noirq(pm_message_t state)
 		struct device *dev = to_device(dpm_noirq_list.next);
 		int error;
 
+		ktime_t calltime;
+
 		get_device(dev);
 		list_move_tail(&dev->power.entry, &dpm_suspended_list);
 		mutex_unlock(&dpm_list_mtx);
 
+		calltime = ktime_get();
 		error = device_resume_noirq(dev, state);
+		dpm_timing_dev(dev, DPM_PHASE_RESUME_NOIRQ, calltime, error, false);
 		if (error)
 			pm_dev_err(dev, state, " early", error);
 
@@ -487,11 +689,33 @@ void dpm_resume_noirq(pm_message_t state)
 		put_device(dev);
 	}
 	mutex_unlock(&dpm_list_mtx);
+	dpm_timing_phase(DPM_PHASE_RESUME_NOIRQ, starttime);
 	dpm_show_time(starttime, state, "early");
 	resume_device_irqs();
 }
 EXPORT_SYMBOL_GPL(dpm_resume_noirq);
 
+static bool is_async(struct device *dev)
+{
+	return dev->power.async_suspend && pm_async_enabled
+		&& !pm_trace_is_enabled();
+}
+
+/*
+ * With pm_async_resume set, resume every device that has not opted out
+ * asynchronously. device_resume() waits for the parent, so independent
+ * subtrees resume in parallel while each branch stays in order.
+ */
+static bool is_async_resume(struct device *dev)
+{
+	if (!dev)
+		return false;
+	if (is_async(dev))
+		return true;
+	return pm_async_resume_auto && pm_async_enabled &&
+		!dev->power.no_async_resume && !pm_trace_is_enabled();
+}
+
 /**
  * legacy_resume - Execute a legacy (bus or class) resume callback for device.
  * @dev: Device to resume.
@@ -522,11 +746,13 @@ static int device_resume(struct device *dev, pm_message_t state, bool async)
 {
 	int error = 0;
 	bool put = false;
+	ktime_t calltime;
 
 	TRACE_DEVICE(dev);
 	TRACE_RESUME(0);
 
-	dpm_wait(dev->parent, async);
+	dpm_wait(dev->parent, async || is_async_resume(dev->parent));
+	calltime = ktime_get();
 	device_lock(dev);
 
 	/*
@@ -577,6 +803,7 @@ static int device_resume(struct device *dev, pm_message_t state, bool async)
 
  End:
 	dev->power.is_suspended = false;
+	dpm_timing_dev(dev, DPM_PHASE_RESUME, calltime, error, async);
 
  Unlock:
 	device_unlock(dev);
@@ -601,12 +828,6 @@ static void async_resume(void *data, async_cookie_t cookie)
 	put_device(dev);
 }
 
-static bool is_async(struct device *dev)
-{
-	return dev->power.async_suspend && pm_async_enabled
-		&& !pm_trace_is_enabled();
-}
-
 /**
  *	dpm_drv_timeout - Driver suspend / resume watchdog handler
  *	@data: struct device which timed out
@@ -649,9 +870,11 @@ void dpm_resume(pm_message_t state)
 	pm_transition = state;
 	async_error = 0;
 
-	list_for_each_entry(dev, &dpm_suspended_list, power.entry) {
+	list_for_each_entry(dev, &dpm_suspended_list, power.entry)
 		INIT_COMPLETION(dev->power.completion);
-		if (is_async(dev)) {
+
+	list_for_each_entry(dev, &dpm_suspended_list, power.entry) {
+		if (is_async_resume(dev)) {
 			get_device(dev);
 			async_schedule(async_resume, dev);
 		}
@@ -660,7 +883,7 @@ void dpm_resume(pm_message_t state)
 	while (!list_empty(&dpm_suspended_list)) {
 		dev = to_device(dpm_suspended_list.next);
 		get_device(dev);
-		if (!is_async(dev)) {
+		if (!is_async_resume(dev)) {
 			int error;
 
 			mutex_unlock(&dpm_list_mtx);
@@ -677,6 +900,7 @@ void dpm_resume(pm_message_t state)
 	}
 	mutex_unlock(&dpm_list_mtx);
 	async_synchronize_full();
+	dpm_timing_phase(DPM_PHASE_RESUME, starttime);
 	dpm_show_time(starttime, state, NULL);
 }
 
@@ -720,6 +944,7 @@ static void device_complete(struct device *dev, pm_message_t state)
 void dpm_complete(pm_message_t state)
 {
 	struct list_head list;
+	ktime_t starttime = ktime_get();
 
 	might_sleep();
 
@@ -727,19 +952,23 @@ void dpm_complete(pm_message_t state)
 	mutex_lock(&dpm_list_mtx);
 	while (!list_empty(&dpm_prepared_list)) {
 		struct device *dev = to_device(dpm_prepared_list.prev);
+		ktime_t calltime;
 
 		get_device(dev);
 		dev->power.is_prepared = false;
 		list_move(&dev->power.entry, &list);
 		mutex_unlock(&dpm_list_mtx);
 
+		calltime = ktime_get();
 		device_complete(dev, state);
+		dpm_timing_dev(dev, DPM_PHASE_COMPLETE, calltime, 0, false);
 
 		mutex_lock(&dpm_list_mtx);
 		put_device(dev);
 	}
 	list_splice(&list, &dpm_list);
 	mutex_unlock(&dpm_list_mtx);
+	dpm_timing_phase(DPM_PHASE_COMPLETE, starttime);
 }
 
 /**
@@ -833,11 +1062,14 @@ int dpm_suspend_noirq(pm_message_t state)
 	mutex_lock(&dpm_list_mtx);
 	while (!list_empty(&dpm_suspended_list)) {
 		struct device *dev = to_device(dpm_suspended_list.prev);
+		ktime_t calltime;
 
 		get_device(dev);
 		mutex_unlock(&dpm_list_mtx);
 
+		calltime = ktime_get();
 		error = device_suspend_noirq(dev, state);
+		dpm_timing_dev(dev, DPM_PHASE_SUSPEND_NOIRQ, calltime, error, false);
 
 		mutex_lock(&dpm_list_mtx);
 		if (error) {
@@ -850,6 +1082,7 @@ int dpm_suspend_noirq(pm_message_t state)
 		put_device(dev);
 	}
 	mutex_unlock(&dpm_list_mtx);
+	dpm_timing_phase(DPM_PHASE_SUSPEND_NOIRQ, starttime);
 	if (error)
 		dpm_resume_noirq(resume_event(state));
 	else
@@ -891,8 +1124,10 @@ static int __device_suspend(struct device *dev, pm_message_t state, bool async)
 	int error = 0;
 	struct timer_list timer;
 	struct dpm_drv_wd_data data;
+	ktime_t calltime;
 
 	dpm_wait_for_children(dev, async);
+	calltime = ktime_get();
 
 	data.dev = dev;
 	data.tsk = get_current();
@@ -953,6 +1188,7 @@ static int __device_suspend(struct device *dev, pm_message_t state, bool async)
 
  End:
 	dev->power.is_suspended = !error;
+	dpm_timing_dev(dev, DPM_PHASE_SUSPEND, calltime, error, async);
 
 	device_unlock(dev);
 
@@ -1033,6 +1269,7 @@ int dpm_suspend(pm_message_t state)
 	}
 	mutex_unlock(&dpm_list_mtx);
 	async_synchronize_full();
+	dpm_timing_phase(DPM_PHASE_SUSPEND, starttime);
 	if (!error)
 		error = async_error;
 	if (!error)
@@ -1096,18 +1333,24 @@ static int device_prepare(struct device *dev, pm_message_t state)
  */
 int dpm_prepare(pm_message_t state)
 {
+	ktime_t starttime = ktime_get();
 	int error = 0;
 
 	might_sleep();
 
+	dpm_timing_start_cycle(state);
+
 	mutex_lock(&dpm_list_mtx);
 	while (!list_empty(&dpm_list)) {
 		struct device *dev = to_device(dpm_list.next);
+		ktime_t calltime;
 
 		get_device(dev);
 		mutex_unlock(&dpm_list_mtx);
 
+		calltime = ktime_get();
 		error = device_prepare(dev, state);
+		dpm_timing_dev(dev, DPM_PHASE_PREPARE, calltime, error, false);
 
 		mutex_lock(&dpm_list_mtx);
 		if (error) {
@@ -1128,6 +1371,7 @@ int dpm_prepare(pm_message_t state)
 		put_device(dev);
 	}
 	mutex_unlock(&dpm_list_mtx);
+	dpm_timing_phase(DPM_PHASE_PREPARE, starttime);
 	return error;
 }
 
@@ -28,6 +28,7 @@
 #include <linux/workqueue.h>
 #include <linux/kthread.h>
 #include <linux/mutex.h>
+#include <linux/irq_work.h>
 
 #include <asm/cputime.h>
 
@@ -52,6 +53,13 @@ struct cpufreq_interactive_cpuinfo {
 	struct cpufreq_frequency_table *freq_table;
 	unsigned int target_freq;
 	int governor_enabled;
+	struct irq_work kick_work;
+	/*
+	 * Protects the sample window and the arming of cpu_timer against
+	 * the scheduler callback, which may run for this CPU on another.
+	 */
+	spinlock_t load_lock;
+	unsigned long sched_eval_jiffies;
 #if 1//def CONFIG_MACH_X3
 	unsigned long boosted;
 #endif /* CONFIG_MACH_X3 */
@@ -109,6 +117,19 @@ static unsigned long min_sample_time;
 #define DEFAULT_TIMER_RATE 20000;
 static unsigned long timer_rate;
 
+/*
+ * If set, load is pushed by the scheduler on enqueue, dequeue and tick
+ * instead of being sampled by a re-armed per-cpu timer.
+ */
+static unsigned long sched_input;
+
+/*
+ * The minimum time between two scheduler-driven evaluations of a CPU,
+ * unless a task is enqueued on an already busy CPU.
+ */
+#define DEFAULT_SCHED_INPUT_RATE 5000
+static unsigned long sched_input_rate;
+
 /*
  * The minimum delay before frequency is allowed to raise over normal rate.
  * Since it must remain at high frequency for a minimum of MIN_SAMPLE_TIME
@@ -465,7 +486,28 @@ static inline cputime64_t get_cpu_iowait_time(
 	return iowait_time;
 }
 
-static void cpufreq_interactive_timer(unsigned long data)
+/*
+ * Kick the frequency change threads for pending up/down requests.  In
+ * scheduler-driven mode we are called with a runqueue lock held, where
+ * waking a task could deadlock, so the kick is deferred to irq_work.
+ */
+static void cpufreq_interactive_kick(struct irq_work *work)
+{
+	if (!cpumask_empty(&up_cpumask))
+		wake_up_process(up_task);
+	if (!cpumask_empty(&down_cpumask))
+		queue_work(down_wq, &freq_scale_down_work);
+}
+
+/*
+ * Evaluate the load of @cpu over the current sample window and queue a
+ * new target frequency if needed.  Called with pcpu->load_lock held.
+ * Returns -ENODATA if the window was cancelled, -EAGAIN if the window is
+ * too short or a ramp down is held off, 1 if a speed change was queued
+ * and 0 otherwise.
+ */
+static int __cpufreq_interactive_evaluate(unsigned int cpu,
+		struct cpufreq_interactive_cpuinfo *pcpu)
 {
 	unsigned int delta_idle;
 	unsigned int delta_iowait;
@@ -475,19 +517,12 @@ static void cpufreq_interactive_timer(unsigned long data)
 	u64 time_in_idle;
 	u64 time_in_iowait;
 	u64 idle_exit_time;
-	struct cpufreq_interactive_cpuinfo *pcpu =
-		&per_cpu(cpuinfo, data);
 	u64 now_idle;
 	u64 now_iowait;
 	unsigned int new_freq;
 	unsigned int index;
 	unsigned long flags;
 
-	smp_rmb();
-
-	if (!pcpu->governor_enabled)
-		goto exit;
-
 	/*
 	 * Once pcpu->timer_run_time is updated to >= pcpu->idle_exit_time,
 	 * this lets idle exit know the current idle time sample has
@@ -500,13 +535,13 @@ static void cpufreq_interactive_timer(unsigned long data)
 	time_in_idle = pcpu->time_in_idle;
 	time_in_iowait = pcpu->time_in_iowait;
 	idle_exit_time = pcpu->idle_exit_time;
-	now_idle = get_cpu_idle_time_us(data, &pcpu->timer_run_time);
-	now_iowait = get_cpu_iowait_time(data, NULL);
+	now_idle = get_cpu_idle_time_us(cpu, &pcpu->timer_run_time);
+	now_iowait = get_cpu_iowait_time(cpu, NULL);
 	smp_wmb();
 
 	/* If we raced with cancelling a timer, skip. */
 	if (!idle_exit_time)
-		goto exit;
+		return -ENODATA;
 
 	delta_idle = (unsigned int) cputime64_sub(now_idle, time_in_idle);
 	delta_iowait = (unsigned int) cputime64_sub(now_iowait, time_in_iowait);
@@ -517,7 +552,14 @@ static void cpufreq_interactive_timer(unsigned long data)
 	 * If timer ran less than 1ms after short-term sample started, retry.
 	 */
 	if (delta_time < 1000)
-		goto rearm;
+		return -EAGAIN;
+
+	/* The scheduler has no timer to restart the window for it. */
+	if (sched_input) {
+		pcpu->time_in_idle = now_idle;
+		pcpu->time_in_iowait = now_iowait;
+		pcpu->idle_exit_time = pcpu->timer_run_time;
+	}
 
 	if (delta_idle > delta_time)
 		cpu_load = 0;
@@ -564,14 +606,14 @@ static void cpufreq_interactive_timer(unsigned long data)
 					   new_freq, CPUFREQ_RELATION_H,
 					   &index)) {
 		pr_warn_once("timer %d: cpufreq_frequency_table_target error\n",
-			     (int) data);
-		goto rearm;
+			     (int) cpu);
+		return -EAGAIN;
 	}
 
 	new_freq = pcpu->freq_table[index].frequency;
 
 	if (pcpu->target_freq == new_freq)
-		goto rearm_if_notmax;
+		return 0;
 
 	/*
 	 * Do not scale down unless we have been at this frequency for the
@@ -580,7 +622,7 @@ static void cpufreq_interactive_timer(unsigned long data)
 	if (new_freq < pcpu->target_freq) {
 		if (cputime64_sub(pcpu->timer_run_time, pcpu->freq_change_time)
 		    < min_sample_time)
-			goto rearm;
+			return -EAGAIN;
 	}
 
 	/*
@@ -600,18 +642,85 @@ static void cpufreq_interactive_timer(unsigned long data)
 	if (new_freq < pcpu->target_freq) {
 		pcpu->target_freq = new_freq;
 		spin_lock_irqsave(&down_cpumask_lock, flags);
-		cpumask_set_cpu(data, &down_cpumask);
+		cpumask_set_cpu(cpu, &down_cpumask);
 		spin_unlock_irqrestore(&down_cpumask_lock, flags);
-		queue_work(down_wq, &freq_scale_down_work);
 	} else {
 		pcpu->target_freq = new_freq;
 		spin_lock_irqsave(&up_cpumask_lock, flags);
-		cpumask_set_cpu(data, &up_cpumask);
+		cpumask_set_cpu(cpu, &up_cpumask);
 		spin_unlock_irqrestore(&up_cpumask_lock, flags);
-		wake_up_process(up_task);
 	}
 
-rearm_if_notmax:
+	return 1;
+}
+
+/*
+ * The frequency change threads are kicked after dropping load_lock: the
+ * scheduler callback takes load_lock under a runqueue lock, so waking a
+ * task with load_lock held could deadlock.
+ */
+static int cpufreq_interactive_evaluate(unsigned int cpu,
+		struct cpufreq_interactive_cpuinfo *pcpu, bool defer)
+{
+	unsigned long flags;
+	int ret;
+
+	spin_lock_irqsave(&pcpu->load_lock, flags);
+	ret = __cpufreq_interactive_evaluate(cpu, pcpu);
+	spin_unlock_irqrestore(&pcpu->load_lock, flags);
+
+	if (ret <= 0)
+		return ret;
+
+	if (defer)
+		irq_work_queue(&per_cpu(cpuinfo, smp_processor_id()).kick_work);
+	else
+		cpufreq_interactive_kick(NULL);
+
+	return 0;
+}
+
+/*
+ * Arm the timer of @cpu, from any CPU, unless it is already pending.
+ */
+static void cpufreq_interactive_timer_start(unsigned int cpu,
+		unsigned long expires)
+{
+	struct cpufreq_interactive_cpuinfo *pcpu = &per_cpu(cpuinfo, cpu);
+	unsigned long flags;
+
+	spin_lock_irqsave(&pcpu->load_lock, flags);
+	if (!timer_pending(&pcpu->cpu_timer)) {
+		pcpu->cpu_timer.expires = expires;
+		add_timer_on(&pcpu->cpu_timer, cpu);
+	}
+	spin_unlock_irqrestore(&pcpu->load_lock, flags);
+}
+
+static void cpufreq_interactive_timer(unsigned long data)
+{
+	struct cpufreq_interactive_cpuinfo *pcpu =
+		&per_cpu(cpuinfo, data);
+	unsigned long flags;
+	int ret;
+
+	smp_rmb();
+
+	if (!pcpu->governor_enabled)
+		goto exit;
+
+	ret = cpufreq_interactive_evaluate(data, pcpu, false);
+
+	/*
+	 * The scheduler keeps feeding busy CPUs; the timer is only used to
+	 * re-evaluate a CPU that went idle above the minimum speed.
+	 */
+	if (sched_input || ret == -ENODATA)
+		goto exit;
+
+	if (ret == -EAGAIN)
+		goto rearm;
+
 	/*
 	 * Already set max speed and don't see a need to change that,
 	 * wait until next idle to re-evaluate, don't need timer.
@@ -620,6 +729,7 @@ rearm_if_notmax:
 		goto exit;
 
 rearm:
+	spin_lock_irqsave(&pcpu->load_lock, flags);
 	if (!timer_pending(&pcpu->cpu_timer)) {
 		/*
 		 * If already at min: if that CPU is idle, don't set timer.
@@ -630,7 +740,7 @@ rearm:
 			smp_rmb();
 
 			if (pcpu->idling)
-				goto exit;
+				goto unlock;
 
 			pcpu->timer_idlecancel = 1;
 		}
@@ -640,18 +750,49 @@ rearm:
 		pcpu->time_in_iowait = get_cpu_iowait_time(
 			data, NULL);
 
-		mod_timer(&pcpu->cpu_timer,
+		mod_timer_pinned(&pcpu->cpu_timer,
 			  jiffies + usecs_to_jiffies(timer_rate));
 	}
+unlock:
+	spin_unlock_irqrestore(&pcpu->load_lock, flags);
 
 exit:
 	return;
 }
 
+/*
+ * Scheduler callback, called with the runqueue of @cpu locked.
+ */
+static void cpufreq_interactive_sched_notify(int cpu,
+		unsigned long nr_running, unsigned int flags)
+{
+	struct cpufreq_interactive_cpuinfo *pcpu = &per_cpu(cpuinfo, cpu);
+	unsigned long now = jiffies;
+
+	if (!pcpu->governor_enabled)
+		return;
+
+	/*
+	 * Rate limit on jiffies so that most enqueues and dequeues don't
+	 * read the clock.  A task woken on an already busy CPU is the start
+	 * of a burst, so don't wait for the rest of the rate limit before
+	 * evaluating it, but still evaluate at most once per tick.
+	 */
+	if (time_before(now, pcpu->sched_eval_jiffies +
+			usecs_to_jiffies(sched_input_rate)) &&
+	    !((flags & SCHED_FREQ_ENQUEUE) && nr_running > 1 &&
+	      now != pcpu->sched_eval_jiffies))
+		return;
+
+	pcpu->sched_eval_jiffies = now;
+	cpufreq_interactive_evaluate(cpu, pcpu, true);
+}
+
 static void cpufreq_interactive_idle_start(void)
 {
 	struct cpufreq_interactive_cpuinfo *pcpu =
 		&per_cpu(cpuinfo, smp_processor_id());
+	unsigned long flags;
 	int pending;
 
 	if (!pcpu->governor_enabled)
@@ -659,10 +800,22 @@ static void cpufreq_interactive_idle_start(void)
 
 	pcpu->idling = 1;
 	smp_wmb();
+	spin_lock_irqsave(&pcpu->load_lock, flags);
 	pending = timer_pending(&pcpu->cpu_timer);
 
 	if (pcpu->target_freq != pcpu->policy->min) {
 #ifdef CONFIG_SMP
+		/*
+		 * In scheduler-driven mode the last update before idle
+		 * already started a new window, just re-evaluate it.
+		 */
+		if (!pending && sched_input) {
+			pcpu->timer_idlecancel = 0;
+			mod_timer_pinned(&pcpu->cpu_timer,
+				  jiffies + usecs_to_jiffies(timer_rate));
+			goto unlock;
+		}
+
 		/*
 		 * Entering idle while not at lowest speed.  On some
 		 * platforms this can hold the other CPU(s) at that speed
@@ -677,7 +830,7 @@ static void cpufreq_interactive_idle_start(void)
 			pcpu->time_in_iowait = get_cpu_iowait_time(
 				smp_processor_id(), NULL);
 			pcpu->timer_idlecancel = 0;
-			mod_timer(&pcpu->cpu_timer,
+			mod_timer_pinned(&pcpu->cpu_timer,
 				  jiffies + usecs_to_jiffies(timer_rate));
 		}
 #endif
@@ -700,16 +853,52 @@ static void cpufreq_interactive_idle_start(void)
 		}
 	}
 
+#ifdef CONFIG_SMP
+unlock:
+#endif
+	spin_unlock_irqrestore(&pcpu->load_lock, flags);
 }
 
 static void cpufreq_interactive_idle_end(void)
 {
 	struct cpufreq_interactive_cpuinfo *pcpu =
 		&per_cpu(cpuinfo, smp_processor_id());
+	unsigned long flags;
 
 	pcpu->idling = 0;
 	smp_wmb();
 
+	if (!pcpu->governor_enabled)
+		return;
+
+	spin_lock_irqsave(&pcpu->load_lock, flags);
+
+	if (sched_input) {
+		/*
+		 * Idle entry at min speed cancels the window; nothing else
+		 * restarts it in scheduler-driven mode, so do it here.
+		 * Otherwise evaluate the window that spans the idle period.
+		 */
+		if (!pcpu->idle_exit_time) {
+			pcpu->time_in_idle =
+				get_cpu_idle_time_us(smp_processor_id(),
+						     &pcpu->idle_exit_time);
+			pcpu->time_in_iowait =
+				get_cpu_iowait_time(smp_processor_id(), NULL);
+			spin_unlock_irqrestore(&pcpu->load_lock, flags);
+			return;
+		}
+		spin_unlock_irqrestore(&pcpu->load_lock, flags);
+
+		if (time_before(jiffies, pcpu->sched_eval_jiffies +
+				usecs_to_jiffies(sched_input_rate)))
+			return;
+
+		pcpu->sched_eval_jiffies = jiffies;
+		cpufreq_interactive_evaluate(smp_processor_id(), pcpu, false);
+		return;
+	}
+
 	/*
 	 * Arm the timer for 1-2 ticks later if not already, and if the timer
 	 * function has already processed the previous load sampling
@@ -722,8 +911,7 @@ static void cpufreq_interactive_idle_end(void)
 	 * run.)
 	 */
 	if (timer_pending(&pcpu->cpu_timer) == 0 &&
-	    pcpu->timer_run_time >= pcpu->idle_exit_time &&
-	    pcpu->governor_enabled) {
+	    pcpu->timer_run_time >= pcpu->idle_exit_time) {
 		pcpu->time_in_idle =
 			get_cpu_idle_time_us(smp_processor_id(),
 					     &pcpu->idle_exit_time);
@@ -731,10 +919,11 @@ static void cpufreq_interactive_idle_end(void)
 			get_cpu_iowait_time(smp_processor_id(),
 						NULL);
 		pcpu->timer_idlecancel = 0;
-		mod_timer(&pcpu->cpu_timer,
+		mod_timer_pinned(&pcpu->cpu_timer,
 			  jiffies + usecs_to_jiffies(timer_rate));
 	}
 
+	spin_unlock_irqrestore(&pcpu->load_lock, flags);
 }
 
 static int cpufreq_interactive_up_task(void *data)
@@ -876,6 +1065,7 @@ DECL_CPUFREQ_INTERACTIVE_ATTR(midrange_max_boost)
 DECL_CPUFREQ_INTERACTIVE_ATTR(sustain_load)
 DECL_CPUFREQ_INTERACTIVE_ATTR(min_sample_time)
 DECL_CPUFREQ_INTERACTIVE_ATTR(timer_rate)
+DECL_CPUFREQ_INTERACTIVE_ATTR(sched_input_rate)
 DECL_CPUFREQ_INTERACTIVE_ATTR(high_freq_min_delay)
 DECL_CPUFREQ_INTERACTIVE_ATTR(max_normal_freq)
 
@@ -972,6 +1162,52 @@ static ssize_t store_dynamic_freq_mode(struct kobject *kobj,
 static struct global_attr dynamic_freq_mode_attr = __ATTR(dynamic_freq_mode,
 		0644, show_dynamic_freq_mode, store_dynamic_freq_mode);
 
+static ssize_t show_sched_input(struct kobject *kobj,
+			struct attribute *attr, char *buf)
+{
+	return sprintf(buf, "%lu\n", sched_input);
+}
+
+static ssize_t store_sched_input(struct kobject *kobj,
+			struct attribute *attr, const char *buf, size_t count)
+{
+	struct cpufreq_interactive_cpuinfo *pcpu;
+	unsigned long val;
+	unsigned int j;
+	int ret;
+
+	ret = strict_strtoul(buf, 0, &val);
+	if (ret < 0)
+		return ret;
+
+	val = !!val;
+	mutex_lock(&gov_state_lock);
+	if (val == sched_input)
+		goto out;
+
+	sched_input = val;
+	smp_wmb();
+
+	if (sched_input) {
+		/* Pending timers run once more and are not re-armed. */
+		sched_set_freq_notifier(cpufreq_interactive_sched_notify);
+		goto out;
+	}
+
+	sched_set_freq_notifier(NULL);
+	for_each_online_cpu(j) {
+		pcpu = &per_cpu(cpuinfo, j);
+		if (pcpu->governor_enabled)
+			cpufreq_interactive_timer_start(j, jiffies + 2);
+	}
+out:
+	mutex_unlock(&gov_state_lock);
+	return count;
+}
+
+static struct global_attr sched_input_attr = __ATTR(sched_input,
+		0644, show_sched_input, store_sched_input);
+
 static struct attribute *interactive_attributes[] = {
 	&go_maxspeed_load_attr.attr,
 	&midrange_freq_attr.attr,
@@ -984,6 +1220,8 @@ static struct attribute *interactive_attributes[] = {
 	&min_sample_time_attr.attr,
 	&dynamic_freq_mode_attr.attr,
 	&timer_rate_attr.attr,
+	&sched_input_attr.attr,
+	&sched_input_rate_attr.attr,
 	//                                                               
 #ifdef CONFIG_ARCH_TEGRA_3x_SOC
 	&cores_states_attr.attr,
@@ -1039,8 +1277,7 @@ static int cpufreq_governor_interactive(struct cpufreq_policy *policy,
 //                                                               
 			smp_wmb();
 
-			if (!timer_pending(&pcpu->cpu_timer))
-				mod_timer(&pcpu->cpu_timer, jiffies + 2);
+			cpufreq_interactive_timer_start(j, jiffies + 2);
 		}
 
 		mutex_lock(&gov_state_lock);
@@ -1060,6 +1297,9 @@ static int cpufreq_governor_interactive(struct cpufreq_policy *policy,
 				mutex_unlock(&gov_state_lock);
 				return rc;
 			}
+			if (sched_input)
+				sched_set_freq_notifier(
+					cpufreq_interactive_sched_notify);
 		}
 #if 1 //def CONFIG_MACH_X3
 		cpufreq_interactive_dynamic_freq_init();
@@ -1090,6 +1330,8 @@ static int cpufreq_governor_interactive(struct cpufreq_policy *policy,
 		active_count--;
 
 		if (active_count == 0) {
+			if (sched_input)
+				sched_set_freq_notifier(NULL);
 			sysfs_remove_group(cpufreq_global_kobject,
 					&interactive_attr_group);
 			kobject_uevent(interactive_kobj, KOBJ_REMOVE);
@@ -1144,6 +1386,7 @@ static int __init cpufreq_interactive_init(void)
 	midrange_go_maxspeed_load = DEFAULT_MID_RANGE_GO_MAXSPEED_LOAD;
 	min_sample_time = DEFAULT_MIN_SAMPLE_TIME;
 	timer_rate = DEFAULT_TIMER_RATE;
+	sched_input_rate = DEFAULT_SCHED_INPUT_RATE;
 	high_freq_min_delay = DEFAULT_HIGH_FREQ_MIN_DELAY;
 	max_normal_freq = DEFAULT_MAX_NORMAL_FREQ;
 
@@ -1153,6 +1396,8 @@ static int __init cpufreq_interactive_init(void)
 		init_timer(&pcpu->cpu_timer);
 		pcpu->cpu_timer.function = cpufreq_interactive_timer;
 		pcpu->cpu_timer.data = i;
+		init_irq_work(&pcpu->kick_work, cpufreq_interactive_kick);
+		spin_lock_init(&pcpu->load_lock);
 	}
 #if 1//def CONFIG_MACH_X3
 	ret = cpufreq_interactive_dynamic_freq_alloc();
@@ -1207,7 +1452,11 @@ module_init(cpufreq_interactive_init);
 
 static void __exit cpufreq_interactive_exit(void)
 {
+	unsigned int i;
+
 	cpufreq_unregister_governor(&cpufreq_gov_interactive);
+	for_each_possible_cpu(i)
+		irq_work_sync(&per_cpu(cpuinfo, i).kick_work);
 	kthread_stop(up_task);
 	put_task_struct(up_task);
 	destroy_workqueue(down_wq);
@@ -23,10 +23,41 @@
 #include <linux/notifier.h>
 #include <linux/of.h>
 #include <linux/sched.h>
+#include <linux/hashtable.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <linux/ktime.h>
 #include <asm/cputime.h>
 
 static spinlock_t cpufreq_stats_lock;
 
+/*
+ * Per-UID time in state. Entries are indexed by the frequency list of the
+ * first policy registered; other policies map onto it through uid_index.
+ */
+#define UID_HASH_BITS	8
+#define UID_TIS_MAGIC	0x53495455	/* "UTIS" */
+#define UID_TIS_VERSION	1
+
+struct uid_entry {
+	uid_t uid;
+	struct hlist_node hash;
+	u64 time_in_state[0];
+};
+
+struct uid_tis_header {
+	u32 magic;
+	u32 version;
+	u32 nr_freqs;
+	u32 nr_uids;
+};
+
+static DEFINE_HASHTABLE(uid_hash_table, UID_HASH_BITS);
+static DEFINE_SPINLOCK(uid_lock);
+static unsigned int *uid_freqs;
+static unsigned int uid_nr_freqs;
+static unsigned int uid_nr_entries;
+
 #define CPUFREQ_STATDEVICE_ATTR(_name, _mode, _show) \
 static struct freq_attr _attr_##_name = {\
 	.attr = {.name = __stringify(_name), .mode = _mode, }, \
@@ -42,6 +73,11 @@ struct cpufreq_stats {
 	unsigned int last_index;
 	cputime64_t *time_in_state;
 	unsigned int *freq_table;
+	unsigned int *uid_index;
+	u64 trans_start;
+	u64 *trans_lat_sum;
+	unsigned int *trans_lat_count;
+	unsigned int *trans_lat_max;
 #ifdef CONFIG_CPU_FREQ_STAT_DETAILS
 	unsigned int *trans_table;
 #endif
@@ -106,6 +142,47 @@ static ssize_t show_current_in_state(struct kobject *kobj,
 	return len;
 }
 
+static struct uid_entry *find_or_register_uid(uid_t uid)
+{
+	struct uid_entry *uid_entry;
+	struct hlist_node *node;
+
+	hash_for_each_possible(uid_hash_table, uid_entry, node, hash, uid) {
+		if (uid_entry->uid == uid)
+			return uid_entry;
+	}
+
+	uid_entry = kzalloc(sizeof(struct uid_entry) +
+			    uid_nr_freqs * sizeof(u64), GFP_ATOMIC);
+	if (!uid_entry)
+		return NULL;
+
+	uid_entry->uid = uid;
+	hash_add(uid_hash_table, &uid_entry->hash, uid);
+	uid_nr_entries++;
+
+	return uid_entry;
+}
+
+/* Called from the tick with the time just charged to @task */
+static void uid_time_in_state_update(struct task_struct *task,
+		struct cpufreq_stats *stats, cputime_t cputime)
+{
+	struct uid_entry *uid_entry;
+	unsigned long flags;
+	int index = stats->last_index;
+
+	if (index < 0 || !stats->uid_index)
+		return;
+
+	spin_lock_irqsave(&uid_lock, flags);
+	uid_entry = find_or_register_uid(task_uid(task));
+	if (uid_entry)
+		uid_entry->time_in_state[stats->uid_index[index]] +=
+			cputime_to_cputime64(cputime);
+	spin_unlock_irqrestore(&uid_lock, flags);
+}
+
 void acct_update_power(struct task_struct *task, cputime_t cputime) {
 	struct cpufreq_power_stats *powerstats;
 	struct cpufreq_stats *stats;
@@ -114,9 +191,14 @@ void acct_update_power(struct task_struct *task, cputime_t cputime) {
 	if (!task)
 		return;
 	cpu_num = task_cpu(task);
-	powerstats = per_cpu(cpufreq_power_stats, cpu_num);
 	stats = per_cpu(cpufreq_stats_table, cpu_num);
-	if (!powerstats || !stats)
+	if (!stats)
+		return;
+
+	uid_time_in_state_update(task, stats, cputime);
+
+	powerstats = per_cpu(cpufreq_power_stats, cpu_num);
+	if (!powerstats)
 		return;
 
 	curr = powerstats->curr[stats->last_index];
@@ -124,6 +206,106 @@ void acct_update_power(struct task_struct *task, cputime_t cputime) {
 }
 EXPORT_SYMBOL_GPL(acct_update_power);
 
+/*
+ * /proc/uid_time_in_state is binary: a struct uid_tis_header, nr_freqs
+ * u32 frequencies in kHz, then nr_uids records of a u32 uid, a u32 pad
+ * and nr_freqs u64 times in clock ticks (USER_HZ).
+ */
+static int uid_time_in_state_show(struct seq_file *m, void *v)
+{
+	struct uid_tis_header hdr;
+	struct uid_entry *uid_entry;
+	struct hlist_node *node;
+	unsigned long flags;
+	u32 rec[2] = { 0, 0 };
+	u64 t;
+	int bkt, i;
+
+	spin_lock_irqsave(&uid_lock, flags);
+	hdr.magic = UID_TIS_MAGIC;
+	hdr.version = UID_TIS_VERSION;
+	hdr.nr_freqs = uid_nr_freqs;
+	hdr.nr_uids = uid_nr_entries;
+	seq_write(m, &hdr, sizeof(hdr));
+	seq_write(m, uid_freqs, uid_nr_freqs * sizeof(u32));
+
+	hash_for_each(uid_hash_table, bkt, node, uid_entry, hash) {
+		rec[0] = uid_entry->uid;
+		seq_write(m, rec, sizeof(rec));
+		for (i = 0; i < uid_nr_freqs; i++) {
+			t = cputime64_to_clock_t(uid_entry->time_in_state[i]);
+			seq_write(m, &t, sizeof(t));
+		}
+	}
+	spin_unlock_irqrestore(&uid_lock, flags);
+
+	return 0;
+}
+
+static int uid_time_in_state_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, uid_time_in_state_show, NULL);
+}
+
+static const struct file_operations uid_time_in_state_fops = {
+	.open		= uid_time_in_state_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+/*
+ * The first table registered defines the uid frequency list; map every
+ * state of @stat onto the closest uid frequency at or below it.
+ */
+static int uid_time_in_state_map(struct cpufreq_stats *stat)
+{
+	unsigned int *freqs = NULL;
+	unsigned long flags;
+	int i, j;
+
+	if (!uid_freqs) {
+		freqs = kmemdup(stat->freq_table,
+				stat->state_num * sizeof(unsigned int),
+				GFP_KERNEL);
+		if (!freqs)
+			return -ENOMEM;
+	}
+
+	spin_lock_irqsave(&uid_lock, flags);
+	if (!uid_freqs) {
+		uid_freqs = freqs;
+		uid_nr_freqs = stat->state_num;
+		freqs = NULL;
+	}
+	for (i = 0, j = 0; i < stat->state_num; i++) {
+		while (j + 1 < uid_nr_freqs &&
+		       uid_freqs[j + 1] <= stat->freq_table[i])
+			j++;
+		stat->uid_index[i] = j;
+	}
+	spin_unlock_irqrestore(&uid_lock, flags);
+
+	kfree(freqs);
+	return 0;
+}
+
+static void uid_time_in_state_free(void)
+{
+	struct uid_entry *uid_entry;
+	struct hlist_node *node, *tmp;
+	int bkt;
+
+	hash_for_each_safe(uid_hash_table, bkt, node, tmp, uid_entry, hash) {
+		hash_del(&uid_entry->hash);
+		kfree(uid_entry);
+	}
+	kfree(uid_freqs);
+	uid_freqs = NULL;
+	uid_nr_freqs = 0;
+	uid_nr_entries = 0;
+}
+
 static ssize_t show_total_trans(struct cpufreq_policy *policy, char *buf)
 {
 	struct cpufreq_stats *stat = per_cpu(cpufreq_stats_table, policy->cpu);
@@ -149,6 +331,37 @@ static ssize_t show_time_in_state(struct cpufreq_policy *policy, char *buf)
 	return len;
 }
 
+static ssize_t show_trans_latency(struct cpufreq_policy *policy, char *buf)
+{
+	ssize_t len = 0;
+	unsigned int count, k;
+	int i, j;
+
+	struct cpufreq_stats *stat = per_cpu(cpufreq_stats_table, policy->cpu);
+	if (!stat)
+		return 0;
+
+	spin_lock(&cpufreq_stats_lock);
+	for (i = 0; i < stat->state_num; i++) {
+		for (j = 0; j < stat->state_num; j++) {
+			k = i * stat->max_state + j;
+			count = stat->trans_lat_count[k];
+			if (!count)
+				continue;
+			len += scnprintf(buf + len, PAGE_SIZE - len,
+					"%u %u %u %llu %u\n",
+					stat->freq_table[i],
+					stat->freq_table[j], count,
+					(unsigned long long)
+					div_u64(stat->trans_lat_sum[k], count),
+					stat->trans_lat_max[k]);
+		}
+	}
+	spin_unlock(&cpufreq_stats_lock);
+	return len;
+}
+CPUFREQ_STATDEVICE_ATTR(trans_latency, 0444, show_trans_latency);
+
 #ifdef CONFIG_CPU_FREQ_STAT_DETAILS
 static ssize_t show_trans_table(struct cpufreq_policy *policy, char *buf)
 {
@@ -205,6 +418,7 @@ static struct attribute *default_attrs[] = {
 #ifdef CONFIG_CPU_FREQ_STAT_DETAILS
 	&_attr_trans_table.attr,
 #endif
+	&_attr_trans_latency.attr,
 	NULL
 };
 static struct attribute_group stats_attr_group = {
@@ -298,7 +512,8 @@ static int cpufreq_stats_create_table(struct cpufreq_policy *policy,
 	stat->cpu = cpu;
 	per_cpu(cpufreq_stats_table, cpu) = stat;
 
-	alloc_size = count * sizeof(int) + count * sizeof(cputime64_t);
+	alloc_size = 2 * count * sizeof(int) + count * sizeof(cputime64_t);
+	alloc_size += count * count * (2 * sizeof(int) + sizeof(u64));
 
 #ifdef CONFIG_CPU_FREQ_STAT_DETAILS
 	alloc_size += count * count * sizeof(int);
@@ -309,10 +524,17 @@ static int cpufreq_stats_create_table(struct cpufreq_policy *policy,
 		ret = -ENOMEM;
 		goto error_out;
 	}
-	stat->freq_table = (unsigned int *)(stat->time_in_state + count);
+
+	/* 64-bit arrays first to keep them naturally aligned */
+	stat->trans_lat_sum = (u64 *)(stat->time_in_state + count);
+	stat->freq_table = (unsigned int *)(stat->trans_lat_sum +
+					    count * count);
+	stat->uid_index = stat->freq_table + count;
+	stat->trans_lat_count = stat->uid_index + count;
+	stat->trans_lat_max = stat->trans_lat_count + count * count;
 
 #ifdef CONFIG_CPU_FREQ_STAT_DETAILS
-	stat->trans_table = stat->freq_table + count;
+	stat->trans_table = stat->trans_lat_max + count * count;
 #endif
 	j = 0;
 	for (i = 0; table[i].frequency != CPUFREQ_TABLE_END; i++) {
@@ -331,6 +553,8 @@ static int cpufreq_stats_create_table(struct cpufreq_policy *policy,
 		j++;
 	}
 	stat->state_num = j;
+	if (uid_time_in_state_map(stat))
+		stat->uid_index = NULL;
 	spin_lock(&cpufreq_stats_lock);
 	stat->last_time = get_jiffies_64();
 	stat->last_index = freq_table_get_index(stat, policy->cur);
@@ -427,6 +651,16 @@ static int cpufreq_stat_notifier_trans(struct notifier_block *nb,
 	struct cpufreq_freqs *freq = data;
 	struct cpufreq_stats *stat;
 	int old_index, new_index;
+	unsigned int lat, k;
+
+	if (val == CPUFREQ_PRECHANGE) {
+		spin_lock(&cpufreq_stats_lock);
+		stat = per_cpu(cpufreq_stats_table, freq->cpu);
+		if (stat)
+			stat->trans_start = ktime_to_ns(ktime_get());
+		spin_unlock(&cpufreq_stats_lock);
+		return 0;
+	}
 
 	if (val != CPUFREQ_POSTCHANGE)
 		return 0;
@@ -449,10 +683,22 @@ static int cpufreq_stat_notifier_trans(struct notifier_block *nb,
 	}
 
 	stat->last_index = new_index;
+	if (old_index >= 0 && new_index >= 0) {
+		k = old_index * stat->max_state + new_index;
 #ifdef CONFIG_CPU_FREQ_STAT_DETAILS
-	if (old_index >= 0 && new_index >= 0)
-		stat->trans_table[old_index * stat->max_state + new_index]++;
+		stat->trans_table[k]++;
 #endif
+		if (stat->trans_start) {
+			/* PRECHANGE to POSTCHANGE, including any rail change */
+			lat = div_u64(ktime_to_ns(ktime_get()) -
+				      stat->trans_start, NSEC_PER_USEC);
+			stat->trans_lat_sum[k] += lat;
+			stat->trans_lat_count[k]++;
+			if (lat > stat->trans_lat_max[k])
+				stat->trans_lat_max[k] = lat;
+		}
+	}
+	stat->trans_start = 0;
 	stat->total_trans++;
 	spin_unlock(&cpufreq_stats_lock);
 	return 0;
@@ -559,6 +805,10 @@ static int __init cpufreq_stats_init(void)
 	if (ret)
 		pr_warn("Cannot create sysfs file for cpufreq current stats\n");
 
+	if (!proc_create("uid_time_in_state", 0444, NULL,
+			 &uid_time_in_state_fops))
+		pr_warn("Cannot create /proc/uid_time_in_state\n");
+
 	return 0;
 }
 static void __exit cpufreq_stats_exit(void)
@@ -575,6 +825,8 @@ static void __exit cpufreq_stats_exit(void)
 		cpufreq_stats_free_sysfs(cpu);
 	}
 	cpufreq_powerstats_free();
+	remove_proc_entry("uid_time_in_state", NULL);
+	uid_time_in_state_free();
 }
 
 MODULE_AUTHOR("Zou Nan hai <nanhai.zou@intel.com>");
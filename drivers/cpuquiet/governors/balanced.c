@@ -77,7 +77,7 @@ static void calculate_load_timer(unsigned long data)
 	if (!load_timer_active)
 		return;
 
-	for_each_online_cpu(i) {
+	for_each_cpu(i, cpu_active_mask) {
 		struct idle_info *iinfo = &per_cpu(idleinfo, i);
 		unsigned int *load = &per_cpu(cpu_load, i);
 
@@ -104,7 +104,7 @@ static void start_load_timer(void)
 
 	load_timer_active = true;
 
-	for_each_online_cpu(i) {
+	for_each_cpu(i, cpu_active_mask) {
 		struct idle_info *iinfo = &per_cpu(idleinfo, i);
 
 		iinfo->idle_current =
@@ -128,7 +128,7 @@ static unsigned int get_slowest_cpu_n(void)
 	unsigned long minload = ULONG_MAX;
 	int i;
 
-	for_each_online_cpu(i) {
+	for_each_cpu(i, cpu_active_mask) {
 		unsigned int *load = &per_cpu(cpu_load, i);
 
 		if ((i > 0) && (minload > *load)) {
@@ -145,7 +145,7 @@ static unsigned int cpu_highest_speed(void)
 	unsigned int maxload = 0;
 	int i;
 
-	for_each_online_cpu(i) {
+	for_each_cpu(i, cpu_active_mask) {
 		unsigned int *load = &per_cpu(cpu_load, i);
 
 		maxload = max(maxload, *load);
@@ -159,7 +159,7 @@ static unsigned int count_slow_cpus(unsigned int limit)
 	unsigned int cnt = 0;
 	int i;
 
-	for_each_online_cpu(i) {
+	for_each_cpu(i, cpu_active_mask) {
 		unsigned int *load = &per_cpu(cpu_load, i);
 
 		if (*load <= limit)
@@ -222,7 +222,7 @@ static unsigned int get_avg_nr_runnables(void)
 	struct runnables_avg_sample *sample;
 	u64 integral, old_integral, delta_integral, delta_time, cur_time;
 
-	for_each_online_cpu(i) {
+	for_each_cpu(i, cpu_active_mask) {
 		sample = &per_cpu(avg_nr_sample, i);
 		integral = nr_running_integral(i);
 		old_integral = sample->previous_integral;
@@ -255,20 +255,49 @@ static unsigned int get_avg_nr_runnables(void)
 	return sum;
 }
 
-static CPU_SPEED_BALANCE balanced_speed_balance(void)
+/*
+ * Runnable threads prediction: a decayed history (level) of the average
+ * number of runnable threads and of its trend is kept, and the demand of
+ * the next window is predicted as level + trend.  The prediction is never
+ * below the last sample, so bursts still online cores right away, while
+ * short dips don't take cores offline.
+ */
+static bool nr_run_predict;
+static unsigned int nr_run_decay = 75;	/* history weight, percent */
+static bool nr_run_history_valid;
+static long nr_run_level;
+static long nr_run_trend;
+
+static unsigned int predict_avg_nr_runnables(unsigned int avg_nr_run)
+{
+	unsigned int decay = min(nr_run_decay, 100U);
+	long level, predicted;
+
+	if (!nr_run_history_valid) {
+		nr_run_history_valid = true;
+		nr_run_level = avg_nr_run;
+		nr_run_trend = 0;
+		return avg_nr_run;
+	}
+
+	level = (nr_run_level * decay + (long)avg_nr_run * (100 - decay)) / 100;
+	nr_run_trend = (nr_run_trend * decay +
+			(level - nr_run_level) * (100 - decay)) / 100;
+	nr_run_level = level;
+
+	predicted = level + nr_run_trend;
+	return max_t(long, predicted, avg_nr_run);
+}
+
+static unsigned int balanced_nr_run(void)
 {
-	unsigned long highest_speed = cpu_highest_speed();
-	unsigned long balanced_speed = highest_speed * balance_level / 100;
-	unsigned long skewed_speed = balanced_speed / 2;
-	unsigned int nr_cpus = num_online_cpus();
-	unsigned int max_cpus = pm_qos_request(PM_QOS_MAX_ONLINE_CPUS) ? : 4;
 	unsigned int avg_nr_run = get_avg_nr_runnables();
 	unsigned int nr_run;
 	unsigned int *current_profile = rt_profiles[rt_profile_sel];
 
-	/* balanced: freq targets for all CPUs are above 50% of highest speed
-	   biased: freq target for at least one CPU is below 50% threshold
-	   skewed: freq targets for at least 2 CPUs are below 25% threshold */
+	if (nr_run_predict)
+		avg_nr_run = predict_avg_nr_runnables(avg_nr_run);
+
 	for (nr_run = 1; nr_run < ARRAY_SIZE(rt_profile_default); nr_run++) {
 		unsigned int nr_threshold = current_profile[nr_run - 1];
 		if (nr_run_last <= nr_run)
@@ -278,6 +307,22 @@ static CPU_SPEED_BALANCE balanced_speed_balance(void)
 	}
 	nr_run_last = nr_run;
 
+	return nr_run;
+}
+
+static CPU_SPEED_BALANCE balanced_speed_balance(void)
+{
+	unsigned long highest_speed = cpu_highest_speed();
+	unsigned long balanced_speed = highest_speed * balance_level / 100;
+	unsigned long skewed_speed = balanced_speed / 2;
+	unsigned int nr_cpus = num_active_cpus();
+	unsigned int max_cpus = pm_qos_request(PM_QOS_MAX_ONLINE_CPUS) ? : 4;
+	unsigned int nr_run = balanced_nr_run();
+
+	/* balanced: freq targets for all CPUs are above 50% of highest speed
+	   biased: freq target for at least one CPU is below 50% threshold
+	   skewed: freq targets for at least 2 CPUs are below 25% threshold */
+
 	if (count_slow_cpus(skewed_speed) >= 2 || nr_cpus > max_cpus ||
 		nr_run < nr_cpus)
 		return CPU_SPEED_SKEWED;
@@ -304,6 +349,10 @@ static void balanced_work_func(struct work_struct *work)
 		cpu = get_slowest_cpu_n();
 		if (cpu < nr_cpu_ids) {
 			up = false;
+			/* keep the cores the next window is expected to need */
+			if (nr_run_predict &&
+			    balanced_nr_run() >= num_active_cpus())
+				cpu = nr_cpu_ids;
 			queue_delayed_work(balanced_wq,
 						 &balanced_work, up_delay);
 		} else
@@ -315,7 +364,7 @@ static void balanced_work_func(struct work_struct *work)
 
 		/* cpu speed is up and balanced - one more on-line */
 		case CPU_SPEED_BALANCED:
-			cpu = cpumask_next_zero(0, cpu_online_mask);
+			cpu = cpumask_next_zero(0, cpu_active_mask);
 			if (cpu < nr_cpu_ids)
 				up = true;
 			break;
@@ -427,6 +476,12 @@ static void core_bias_callback (struct cpuquiet_attribute *attr)
 	}
 }
 
+static void nr_run_predict_callback(struct cpuquiet_attribute *attr)
+{
+	/* start from a fresh history */
+	nr_run_history_valid = false;
+}
+
 CPQ_BASIC_ATTRIBUTE(balance_level, 0644, uint);
 CPQ_BASIC_ATTRIBUTE(idle_bottom_freq, 0644, uint);
 CPQ_BASIC_ATTRIBUTE(idle_top_freq, 0644, uint);
@@ -434,6 +489,8 @@ CPQ_BASIC_ATTRIBUTE(load_sample_rate, 0644, uint);
 CPQ_ATTRIBUTE(core_bias, 0644, uint, core_bias_callback);
 CPQ_ATTRIBUTE(up_delay, 0644, ulong, delay_callback);
 CPQ_ATTRIBUTE(down_delay, 0644, ulong, delay_callback);
+CPQ_ATTRIBUTE(nr_run_predict, 0644, bool, nr_run_predict_callback);
+CPQ_BASIC_ATTRIBUTE(nr_run_decay, 0644, uint);
 
 static struct attribute *balanced_attributes[] = {
 	&balance_level_attr.attr,
@@ -443,6 +500,8 @@ static struct attribute *balanced_attributes[] = {
 	&down_delay_attr.attr,
 	&load_sample_rate_attr.attr,
 	&core_bias_attr.attr,
+	&nr_run_predict_attr.attr,
+	&nr_run_decay_attr.attr,
 	NULL,
 };
 
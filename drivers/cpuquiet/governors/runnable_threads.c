@@ -76,7 +76,7 @@ static unsigned int get_avg_nr_runnables(void)
 	struct runnables_avg_sample *sample;
 	u64 integral, old_integral, delta_integral, delta_time, cur_time;
 
-	for_each_online_cpu(i) {
+	for_each_cpu(i, cpu_active_mask) {
 		sample = &per_cpu(avg_nr_sample, i);
 		integral = nr_running_integral(i);
 		old_integral = sample->previous_integral;
@@ -118,7 +118,7 @@ static unsigned int get_avg_nr_runnables(void)
 
 static int get_action(unsigned int nr_run)
 {
-	unsigned int nr_cpus = num_online_cpus();
+	unsigned int nr_cpus = num_active_cpus();
 	int max_cpus = pm_qos_request(PM_QOS_MAX_ONLINE_CPUS) ? : 4;
 	int min_cpus = pm_qos_request(PM_QOS_MIN_ONLINE_CPUS);
 
@@ -166,7 +166,7 @@ static unsigned int get_lightest_loaded_cpu_n(void)
 	unsigned int cpu = nr_cpu_ids;
 	int i;
 
-	for_each_online_cpu(i) {
+	for_each_cpu(i, cpu_active_mask) {
 		struct runnables_avg_sample *s = &per_cpu(avg_nr_sample, i);
 		unsigned int nr_runnables = s->avg;
 		if (i > 0 && min_avg_runnables > nr_runnables) {
@@ -188,7 +188,7 @@ static void runnables_work_func(struct work_struct *work)
 
 	action = get_action(nr_run_last);
 	if (action > 0) {
-		cpu = cpumask_next_zero(0, cpu_online_mask);
+		cpu = cpumask_next_zero(0, cpu_active_mask);
 		if (cpu < nr_cpu_ids)
 			cpuquiet_wake_cpu(cpu, false);
 	} else if (action < 0) {
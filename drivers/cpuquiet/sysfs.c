@@ -232,7 +232,7 @@ static ssize_t cpuquiet_state_store(struct kobject *kobj,
 
 static ssize_t show_active(unsigned int cpu, char *buf)
 {
-	return sprintf(buf, "%u\n", cpu_online(cpu));
+	return sprintf(buf, "%u\n", cpu_active(cpu));
 }
 
 static ssize_t store_active(unsigned int cpu, const char *value, size_t count)
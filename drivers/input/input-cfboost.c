@@ -18,6 +18,7 @@
 #include <linux/input.h>
 #include <linux/module.h>
 #include <linux/pm_qos.h>
+#include <linux/cpufreq.h>
 #include <linux/pm_runtime.h>
 #include <linux/syscalls.h>
 
@@ -58,15 +59,49 @@ module_param(boost_time, ulong, 0644);
 static unsigned long boost_cpus;
 module_param(boost_cpus, ulong, 0644);
 
+/* Key events use their own floors; 0 falls back to the touch values */
+static unsigned int key_boost_freq; /* kHz */
+module_param(key_boost_freq, uint, 0644);
+static unsigned long key_boost_cpus;
+module_param(key_boost_cpus, ulong, 0644);
+
+/* Boosts issued, and how many of them raised the current CPU frequency */
+static unsigned long boost_count;
+module_param(boost_count, ulong, 0444);
+static unsigned long boost_freq_used;
+module_param(boost_freq_used, ulong, 0444);
+
+/* Set by the event handler when the pending boost is for a key event */
+#define CFB_BOOST_KEY	0
+static unsigned long boost_flags;
+
 static void cfb_boost(struct kthread_work *w)
 {
-	if (boost_cpus > 0)
-		pm_qos_update_request_timeout(&core_req, boost_cpus,
+	unsigned int freq = boost_freq;
+	unsigned long cpus = boost_cpus;
+
+	if (test_and_clear_bit(CFB_BOOST_KEY, &boost_flags)) {
+		if (key_boost_freq)
+			freq = key_boost_freq;
+		if (key_boost_cpus)
+			cpus = key_boost_cpus;
+	}
+
+	if (!cpus && !freq)
+		return;
+
+	boost_count++;
+
+	if (cpus > 0)
+		pm_qos_update_request_timeout(&core_req, cpus,
 				boost_time * 1000);
 
-	if (boost_freq > 0)
-		pm_qos_update_request_timeout(&freq_req, boost_freq,
+	if (freq > 0) {
+		if (cpufreq_quick_get(0) < freq)
+			boost_freq_used++;
+		pm_qos_update_request_timeout(&freq_req, freq,
 				boost_time * 1000);
+	}
 }
 
 static struct task_struct *boost_kthread;
@@ -96,10 +131,26 @@ static struct kernel_param_ops boost_freq_ops = {
 	.get = boost_freq_get,
 };
 
+/*
+ * EV_KEY also carries buttons: BTN_TOUCH and BTN_TOOL_* from touch
+ * screens, mouse and joystick buttons.  Only real keys count as keys.
+ */
+static bool cfb_is_key(unsigned int type, unsigned int code)
+{
+	if (type != EV_KEY)
+		return false;
+
+	return code < BTN_MISC ||
+	       (code >= KEY_OK && code < BTN_TRIGGER_HAPPY);
+}
+
 static void cfb_input_event(struct input_handle *handle, unsigned int type,
 			    unsigned int code, int value)
 {
-	if (boost_cpus > 0 || boost_freq > 0) {
+	bool key = cfb_is_key(type, code);
+
+	if (boost_cpus > 0 || boost_freq > 0 ||
+	    (key && (key_boost_cpus > 0 || key_boost_freq > 0))) {
 		if (jiffies < last_boost_jiffies ||
 			jiffies > last_boost_jiffies + msecs_to_jiffies(boost_time/2)) {
 #ifdef START_DELAY
@@ -111,6 +162,8 @@ static void cfb_input_event(struct input_handle *handle, unsigned int type,
 				return;
 			}
 #endif
+			if (key)
+				set_bit(CFB_BOOST_KEY, &boost_flags);
 			queue_kthread_work(&boost_worker, &boost_work);
 			last_boost_jiffies = jiffies;
 		}
@@ -338,8 +338,9 @@ static enum skb_state defer_bh(struct usbnet *dev, struct sk_buff *skb,
 	old_state = entry->state;
 	entry->state = state;
 	__skb_unlink(skb, list);
-	spin_unlock(&list->lock);
+	/* hand over under both locks, see usbnet_reset_queue() */
 	spin_lock(&dev->done.lock);
+	spin_unlock(&list->lock);
 	__skb_queue_tail(&dev->done, skb);
 	if (dev->done.qlen == 1)
 		tasklet_schedule(&dev->bh);
@@ -680,8 +681,8 @@ static void usbnet_terminate_urbs(struct usbnet *dev)
 
 	/* maybe wait for deletions to finish. */
 	while (!skb_queue_empty(&dev->rxq)
-		&& !skb_queue_empty(&dev->txq)
-		&& !skb_queue_empty(&dev->done)) {
+		|| !skb_queue_empty(&dev->txq)
+		|| !skb_queue_empty(&dev->done)) {
 			schedule_timeout(msecs_to_jiffies(UNLINK_TIMEOUT_MS));
 			set_current_state(TASK_UNINTERRUPTIBLE);
 			netif_dbg(dev, ifdown, dev->net,
@@ -692,6 +693,35 @@ static void usbnet_terminate_urbs(struct usbnet *dev)
 	remove_wait_queue(&unlink_wakeup, &wait);
 }
 
+/* Restart BQL from scratch; precondition: bh is killed.  What the bh
+ * left on the done list is freed, and tx urbs still in flight will be
+ * completed with no bytes.  defer_bh() holds both list locks while it
+ * moves an skb to the done list, so none can slip past.
+ */
+static void usbnet_reset_queue(struct usbnet *dev)
+{
+	struct sk_buff_head	done;
+	struct sk_buff		*skb;
+	struct skb_data		*entry;
+
+	__skb_queue_head_init(&done);
+
+	spin_lock_irq(&dev->txq.lock);
+	skb_queue_walk(&dev->txq, skb)
+		((struct skb_data *) skb->cb)->length = 0;
+	spin_lock(&dev->done.lock);
+	skb_queue_splice_init(&dev->done, &done);
+	spin_unlock(&dev->done.lock);
+	netdev_reset_queue(dev->net);
+	spin_unlock_irq(&dev->txq.lock);
+
+	while ((skb = __skb_dequeue(&done))) {
+		entry = (struct skb_data *) skb->cb;
+		usb_free_urb(entry->urb);
+		dev_kfree_skb(skb);
+	}
+}
+
 int usbnet_stop (struct net_device *net)
 {
 	struct usbnet		*dev = netdev_priv(net);
@@ -732,6 +762,10 @@ int usbnet_stop (struct net_device *net)
 	dev->flags = 0;
 	del_timer_sync (&dev->delay);
 	tasklet_kill (&dev->bh);
+
+	/* on both paths, and only once no bh can report completions */
+	usbnet_reset_queue(dev);
+
 	if (info->manage_power &&
 	    !test_and_clear_bit(EVENT_NO_RUNTIME_PM, &dev->flags))
 		info->manage_power(dev, 0);
@@ -1194,6 +1228,8 @@ netdev_tx_t usbnet_start_xmit (struct sk_buff *skb,
 	case 0:
 		net->trans_start = jiffies;
 		__usbnet_queue_skb(&dev->txq, skb, tx_start);
+		/* under txq.lock, so tx_complete() can't account it first */
+		netdev_sent_queue(net, length);
 		if (dev->txq.qlen >= TX_QLEN (dev))
 			netif_stop_queue (net);
 	}
@@ -1248,6 +1284,8 @@ static void usbnet_bh (unsigned long param)
 	struct usbnet		*dev = (struct usbnet *) param;
 	struct sk_buff		*skb;
 	struct skb_data		*entry;
+	unsigned int		tx_pkts = 0, tx_bytes = 0;
+	unsigned long		flags;
 
 	while ((skb = skb_dequeue (&dev->done))) {
 		entry = (struct skb_data *) skb->cb;
@@ -1257,6 +1295,9 @@ static void usbnet_bh (unsigned long param)
 			rx_process (dev, skb);
 			continue;
 		case tx_done:
+			tx_pkts++;
+			tx_bytes += entry->length;
+			/* FALLTHROUGH */
 		case rx_cleanup:
 			usb_free_urb (entry->urb);
 			dev_kfree_skb (skb);
@@ -1266,6 +1307,16 @@ static void usbnet_bh (unsigned long param)
 		}
 	}
 
+	/* report the whole batch at once, BQL sizes the limit per completion.
+	 * This also runs from the throttle timer, so serialize it against
+	 * a concurrent tasklet run.
+	 */
+	if (tx_bytes) {
+		spin_lock_irqsave(&dev->done.lock, flags);
+		netdev_completed_queue(dev->net, tx_pkts, tx_bytes);
+		spin_unlock_irqrestore(&dev->done.lock, flags);
+	}
+
 	/* restart RX again after disabling due to high error rate */
 	clear_bit(EVENT_RX_KILL, &dev->flags);
 
@@ -1598,6 +1649,12 @@ int usbnet_resume (struct usb_interface *intf)
 			} else {
 				dev->net->trans_start = jiffies;
 				__skb_queue_tail(&dev->txq, skb);
+				/* stopped while asleep: BQL was reset */
+				if (test_bit(EVENT_DEV_OPEN, &dev->flags))
+					netdev_sent_queue(dev->net,
+						((struct skb_data *)skb->cb)->length);
+				else
+					((struct skb_data *)skb->cb)->length = 0;
 			}
 		}
 
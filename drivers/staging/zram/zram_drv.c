@@ -75,8 +75,16 @@ snappy_decompress_(
 	snappy_compress_(s, sl, d, dl, wm)
 #define DECOMPRESS(s, sl, d, dl)	\
 	snappy_decompress_(s, sl, d, dl)
+#elif defined(CONFIG_ZRAM_LZ4)
+#include <linux/lz4.h>
+#define WMSIZE		LZ4_MEM_COMPRESS
+/* the output is meta->compress_buffer, two pages */
+#define COMPRESS(s, sl, d, dl, wm)	\
+	(*(dl) = 2 * PAGE_SIZE, lz4_compress(s, sl, d, dl, wm))
+#define DECOMPRESS(s, sl, d, dl)	\
+	lz4_decompress_unknownoutputsize(s, sl, d, dl)
 #else
-#error either CONFIG_ZRAM_LZO or CONFIG_ZRAM_SNAPPY must be defined
+#error one of CONFIG_ZRAM_LZO, CONFIG_ZRAM_SNAPPY or CONFIG_ZRAM_LZ4 must be defined
 #endif
 
 /* Globals */
@@ -747,6 +747,27 @@ static inline bool device_async_suspend_enabled(struct device *dev)
 	return !!dev->power.async_suspend;
 }
 
+/*
+ * Opt a device out of automatic asynchronous resume, for devices that
+ * depend on something other than their parent being resumed first.
+ */
+static inline void device_disable_async_resume(struct device *dev)
+{
+	if (!dev->power.is_prepared)
+		dev->power.no_async_resume = true;
+}
+
+static inline void device_enable_async_resume(struct device *dev)
+{
+	if (!dev->power.is_prepared)
+		dev->power.no_async_resume = false;
+}
+
+static inline bool device_async_resume_enabled(struct device *dev)
+{
+	return !dev->power.no_async_resume;
+}
+
 static inline void device_lock(struct device *dev)
 {
 	mutex_lock(&dev->mutex);
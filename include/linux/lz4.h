@@ -0,0 +1,82 @@
+#ifndef __LZ4_H__
+#define __LZ4_H__
+/*
+ *  LZ4 Public Kernel Interface
+ *
+ *  LZ4 is an LZ77 type compressor with a fixed, byte-oriented encoding
+ *  that favours decompression speed over compression ratio. This is
+ *  the raw block format, without the LZ4 frame header.
+ *
+ *  The format is described at http://code.google.com/p/lz4/
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ */
+
+#include <linux/types.h>
+
+#define LZ4_MEM_COMPRESS	(4096 * sizeof(u32))
+#define LZ4HC_MEM_COMPRESS	(32768 * sizeof(u32) + 65536 * sizeof(u16))
+
+/*
+ * lz4_compressbound()
+ * Provides the maximum size that LZ4 may output in a "worst case" scenario
+ * (input data not compressible)
+ */
+static inline size_t lz4_compressbound(size_t isize)
+{
+	return isize + (isize / 255) + 16;
+}
+
+/*
+ * lz4_compress()
+ *	src     : source address of the original data
+ *	src_len : size of the original data
+ *	dst     : output buffer address of the compressed data
+ *	dst_len : in: size of the output buffer, out: compressed size
+ *	wrkmem  : address of the working memory, LZ4_MEM_COMPRESS bytes
+ *	return  : 0 on success, -ENOSPC if the output does not fit
+ *
+ * An output buffer of lz4_compressbound(src_len) bytes never runs out.
+ */
+int lz4_compress(const unsigned char *src, size_t src_len,
+		 unsigned char *dst, size_t *dst_len, void *wrkmem);
+
+/*
+ * lz4hc_compress()
+ * As lz4_compress(), searching harder for matches: slower, but the
+ * output is smaller and decompresses at the same speed.
+ *	wrkmem  : address of the working memory, LZ4HC_MEM_COMPRESS bytes
+ */
+int lz4hc_compress(const unsigned char *src, size_t src_len,
+		   unsigned char *dst, size_t *dst_len, void *wrkmem);
+
+/*
+ * lz4_decompress()
+ * For when the size of the original data is known.
+ *	src     : source address of the compressed data
+ *	src_len : in: bytes available at src, out: bytes consumed
+ *	dest    : output buffer address of the decompressed data
+ *	actual_dest_len : size of the original data
+ *	return  : 0 on success, -EINVAL if the input is corrupt or does
+ *		  not decompress to exactly actual_dest_len bytes
+ */
+int lz4_decompress(const unsigned char *src, size_t *src_len,
+		   unsigned char *dest, size_t actual_dest_len);
+
+/*
+ * lz4_decompress_unknownoutputsize()
+ *	src     : source address of the compressed data
+ *	src_len : size of the compressed data, all of which is consumed
+ *	dest    : output buffer address of the decompressed data
+ *	dest_len: in: size of the output buffer, out: decompressed size
+ *	return  : 0 on success, -EINVAL if the input is corrupt or does
+ *		  not fit in the output buffer
+ *
+ * Neither decompressor reads or writes outside the buffers it is
+ * given, whatever the input.
+ */
+int lz4_decompress_unknownoutputsize(const unsigned char *src, size_t src_len,
+				     unsigned char *dest, size_t *dest_len);
+#endif
@@ -145,6 +145,27 @@ extern u64 nr_running_integral(unsigned int cpu);
 extern unsigned long nr_iowait_cpu(int cpu);
 extern unsigned long this_cpu_load(void);
 
+/*
+ * Scheduler-driven cpufreq input: a governor may register a callback that
+ * is invoked with the target runqueue locked whenever a task is enqueued
+ * or dequeued and on every scheduler tick.
+ */
+#define SCHED_FREQ_ENQUEUE	0x1
+#define SCHED_FREQ_DEQUEUE	0x2
+#define SCHED_FREQ_TICK		0x4
+
+typedef void (*sched_freq_notify_t)(int cpu, unsigned long nr_running,
+				    unsigned int flags);
+#ifdef CONFIG_CPU_FREQ
+extern void sched_set_freq_notifier(sched_freq_notify_t fn);
+#else
+static inline void sched_set_freq_notifier(sched_freq_notify_t fn) { }
+#endif
+
+#if defined(CONFIG_SMP) && defined(CONFIG_HOTPLUG_CPU)
+extern void sched_park_cpu(unsigned int cpu);
+extern void sched_unpark_cpu(unsigned int cpu);
+#endif
 
 extern void calc_global_load(unsigned long ticks);
 
@@ -1197,6 +1218,13 @@ struct sched_entity {
 
 	u64			nr_migrations;
 
+#ifdef CONFIG_SMP
+	/* wakeup-sampled utilization, for small task packing */
+	u64			pack_stamp;
+	u64			pack_exec;
+	unsigned long		pack_util;
+#endif
+
 #ifdef CONFIG_SCHEDSTATS
 	struct sched_statistics statistics;
 #endif
@@ -2012,6 +2040,12 @@ extern unsigned int sysctl_sched_min_granularity;
 extern unsigned int sysctl_sched_wakeup_granularity;
 extern unsigned int sysctl_sched_child_runs_first;
 
+#ifdef CONFIG_SMP
+extern unsigned int sysctl_sched_pack_small_tasks;
+extern unsigned int sysctl_sched_pack_small_pct;
+extern unsigned int sysctl_sched_pack_threshold_pct;
+#endif
+
 enum sched_tunable_scaling {
 	SCHED_TUNABLESCALING_NONE,
 	SCHED_TUNABLESCALING_LOG,
@@ -204,12 +204,23 @@ enum {
 /*
  * The callback notifies userspace to release buffers when skb DMA is done in
  * lower device, the skb last reference should be 0 when calling this.
+ * The zerocopy_success argument is true if zero copy transmit occurred,
+ * false on data copy or out of memory error caused by data copy attempt.
  * The desc is used to track userspace buffer index.
+ *
+ * Socket level zerocopy (MSG_ZEROCOPY) instead uses id/len to name the
+ * range of send calls covered, and refcnt to share one ubuf_info between
+ * all skbs built from those calls.
  */
 struct ubuf_info {
-	void (*callback)(void *);
+	void (*callback)(struct ubuf_info *, bool zerocopy_success);
 	void *arg;
 	unsigned long desc;
+	u32 id;
+	u16 len;
+	u8 zerocopy;
+	u32 bytelen;
+	atomic_t refcnt;
 };
 
 /* This data is invariant across clones and lives at
@@ -273,6 +284,8 @@ enum {
 	SKB_GSO_TCPV6 = 1 << 4,
 
 	SKB_GSO_FCOE = 1 << 5,
+
+	SKB_GSO_UDP_L4 = 1 << 6,
 };
 
 #if BITS_PER_LONG > 32
@@ -328,6 +341,7 @@ typedef unsigned char *sk_buff_data_t;
  *	@tc_index: Traffic control index
  *	@tc_verd: traffic control verdict
  *	@rxhash: the packet hash computed on receive
+ *	@napi_id: id of the NAPI struct this skb came from
  *	@queue_mapping: Queue mapping for multiqueue devices
  *	@ndisc_nodetype: router type (from link layer)
  *	@ooo_okay: allow the mapping of a socket to a queue to be changed
@@ -418,6 +432,9 @@ struct sk_buff {
 #endif
 
 	__u32			rxhash;
+#ifdef CONFIG_NET_RX_BUSY_POLL
+	unsigned int		napi_id;
+#endif
 
 	__u16			queue_mapping;
 	kmemcheck_bitfield_begin(flags2);
@@ -538,6 +555,17 @@ extern bool skb_recycle_check(struct sk_buff *skb, int skb_size);
 
 extern struct sk_buff *skb_morph(struct sk_buff *dst, struct sk_buff *src);
 extern int skb_copy_ubufs(struct sk_buff *skb, gfp_t gfp_mask);
+
+extern struct ubuf_info *sock_zerocopy_alloc(struct sock *sk, size_t size);
+extern struct ubuf_info *sock_zerocopy_realloc(struct sock *sk, size_t size,
+					       struct ubuf_info *uarg);
+extern void sock_zerocopy_callback(struct ubuf_info *uarg, bool success);
+extern void sock_zerocopy_put(struct ubuf_info *uarg);
+extern void sock_zerocopy_put_abort(struct ubuf_info *uarg);
+extern int skb_zerocopy_from_user(struct sock *sk, struct sk_buff *skb,
+				  const unsigned char __user *from, int len,
+				  struct ubuf_info *uarg);
+
 extern struct sk_buff *skb_clone(struct sk_buff *skb,
 				 gfp_t priority);
 extern struct sk_buff *skb_copy(const struct sk_buff *skb,
@@ -615,6 +643,66 @@ static inline struct skb_shared_hwtstamps *skb_hwtstamps(struct sk_buff *skb)
 	return &skb_shinfo(skb)->hwtstamps;
 }
 
+static inline void sock_zerocopy_get(struct ubuf_info *uarg)
+{
+	atomic_inc(&uarg->refcnt);
+}
+
+static inline struct ubuf_info *skb_zcopy(struct sk_buff *skb)
+{
+	bool is_zcopy = skb && skb_shinfo(skb)->tx_flags & SKBTX_DEV_ZEROCOPY;
+
+	return is_zcopy ? skb_shinfo(skb)->destructor_arg : NULL;
+}
+
+static inline bool skb_zcopy_is_sock(struct ubuf_info *uarg)
+{
+	return uarg->callback == sock_zerocopy_callback;
+}
+
+static inline void skb_zcopy_set(struct sk_buff *skb, struct ubuf_info *uarg)
+{
+	if (skb && uarg && !skb_zcopy(skb)) {
+		sock_zerocopy_get(uarg);
+		skb_shinfo(skb)->destructor_arg = uarg;
+		skb_shinfo(skb)->tx_flags |= SKBTX_DEV_ZEROCOPY;
+	}
+}
+
+/* Make @nskb, which was handed frags of @orig, also hold the zerocopy
+ * completion of @orig. Only socket zerocopy buffers can be shared this
+ * way; anything else must have been copied with skb_orphan_frags().
+ */
+static inline void skb_zerocopy_clone(struct sk_buff *nskb,
+				      struct sk_buff *orig)
+{
+	struct ubuf_info *uarg = skb_zcopy(orig);
+
+	if (uarg && skb_zcopy_is_sock(uarg) && !skb_zcopy(nskb))
+		skb_zcopy_set(nskb, uarg);
+}
+
+/* Release references to userspace frags that the stack may keep for a
+ * long or unbounded time. Socket zerocopy buffers are released through
+ * their completion notification instead, so they are left alone here.
+ */
+static inline int skb_orphan_frags(struct sk_buff *skb, gfp_t gfp_mask)
+{
+	struct ubuf_info *uarg = skb_zcopy(skb);
+
+	if (likely(!uarg) || skb_zcopy_is_sock(uarg))
+		return 0;
+	return skb_copy_ubufs(skb, gfp_mask);
+}
+
+/* Frags must be orphaned, even if refcounted, if skb might loop to rx path */
+static inline int skb_orphan_frags_rx(struct sk_buff *skb, gfp_t gfp_mask)
+{
+	if (likely(!skb_zcopy(skb)))
+		return 0;
+	return skb_copy_ubufs(skb, gfp_mask);
+}
+
 /**
  *	skb_queue_empty - check if a queue is empty
  *	@list: queue head
@@ -739,6 +827,26 @@ static inline int skb_header_cloned(const struct sk_buff *skb)
 	return dataref != 1;
 }
 
+/**
+ *	skb_unclone - make the buffer data private to this skb
+ *	@skb: buffer to check
+ *	@pri: priority for memory allocation
+ *
+ *	If the buffer is a clone, reallocate its head so that the data and
+ *	the shared info are no longer shared with the other copies.
+ *
+ *	Returns 0 on success or a negative error code on allocation failure.
+ */
+static inline int skb_unclone(struct sk_buff *skb, gfp_t pri)
+{
+	might_sleep_if(pri & __GFP_WAIT);
+
+	if (skb_cloned(skb))
+		return pskb_expand_head(skb, 0, 0, pri);
+
+	return 0;
+}
+
 /**
  *	skb_header_release - release reference to header
  *	@skb: buffer to operate on
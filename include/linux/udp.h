@@ -29,6 +29,8 @@ struct udphdr {
 /* UDP socket options */
 #define UDP_CORK	1	/* Never send partially complete segments */
 #define UDP_ENCAP	100	/* Set the socket to accept encapsulated packets */
+#define UDP_SEGMENT	103	/* Set GSO segmentation size */
+#define UDP_GRO		104	/* This socket can receive UDP GRO packets */
 
 /* UDP encapsulation types */
 #define UDP_ENCAP_ESPINUDP_NON_IKE	1 /* draft-ietf-ipsec-nat-t-ike-00/01 */
@@ -47,6 +49,9 @@ static inline struct udphdr *udp_hdr(const struct sk_buff *skb)
 
 #define UDP_HTABLE_SIZE_MIN		(CONFIG_BASE_SMALL ? 128 : 256)
 
+/* Maximum number of segments in one UDP GSO or GRO packet */
+#define UDP_MAX_SEGMENTS		(1 << 6UL)
+
 static inline int udp_hashfn(struct net *net, unsigned num, unsigned mask)
 {
 	return (num + net_hash_mix(net)) & mask;
@@ -66,6 +71,7 @@ struct udp_sock {
 	 * when the socket is uncorked.
 	 */
 	__u16		 len;		/* total length of pending frames */
+	__u16		 gso_size;	/* UDP_SEGMENT payload size, 0 if off */
 	/*
 	 * Fields specific to UDP-Lite.
 	 */
@@ -76,7 +82,8 @@ struct udp_sock {
 #define UDPLITE_SEND_CC  0x2  		/* set via udplite setsockopt         */
 #define UDPLITE_RECV_CC  0x4		/* set via udplite setsocktopt        */
 	__u8		 pcflag;        /* marks socket as UDP-Lite if > 0    */
-	__u8		 unused[3];
+	__u8		 gro_enabled;	/* accepts UDP GRO packets (UDP_GRO)  */
+	__u8		 unused[2];
 	/*
 	 * For encapsulation sockets.
 	 */
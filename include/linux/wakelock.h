@@ -17,6 +17,7 @@
 #define _LINUX_WAKELOCK_H
 
 #include <linux/list.h>
+#include <linux/rbtree.h>
 #include <linux/ktime.h>
 
 /* A wake_lock prevents the system from entering suspend or other low power
@@ -35,6 +36,7 @@ enum {
 struct wake_lock {
 #ifdef CONFIG_HAS_WAKELOCK
 	struct list_head    link;
+	struct rb_node      expire_node;
 	int                 flags;
 	const char         *name;
 	unsigned long       expires;
@@ -69,7 +71,7 @@ int wake_lock_active(struct wake_lock *lock);
 /* has_wake_lock returns 0 if no wake locks of the specified type are active,
  * and non-zero if one or more wake locks are held. Specifically it returns
  * -1 if one or more wake locks with no timeout are active or the
- * number of jiffies until all active wake locks time out.
+ * number of jiffies until the next active wake lock times out.
  */
 long has_wake_lock(int type);
 
@@ -59,6 +59,7 @@ struct unix_sock {
 	unsigned char		recursion_level;
 	struct socket_wq	peer_wq;
 	wait_queue_t		peer_wake;
+	struct sk_buff		*skb_cache;	/* recycled for the next send */
 };
 #define unix_sk(__sk) ((struct unix_sock *)__sk)
 
@@ -16,6 +16,8 @@ struct socket;
 extern int inet_release(struct socket *sock);
 extern int inet_stream_connect(struct socket *sock, struct sockaddr * uaddr,
 			       int addr_len, int flags);
+extern int __inet_stream_connect(struct socket *sock, struct sockaddr *uaddr,
+				 int addr_len, int flags);
 extern int inet_dgram_connect(struct socket *sock, struct sockaddr * uaddr,
 			      int addr_len, int flags);
 extern int inet_accept(struct socket *sock, struct socket *newsock, int flags);
@@ -25,6 +27,7 @@ extern ssize_t inet_sendpage(struct socket *sock, struct page *page, int offset,
 			     size_t size, int flags);
 extern int inet_recvmsg(struct kiocb *iocb, struct socket *sock,
 			struct msghdr *msg, size_t size, int flags);
+extern int inet_recv_error(struct sock *sk, struct msghdr *msg, int len);
 extern int inet_shutdown(struct socket *sock, int how);
 extern int inet_listen(struct socket *sock, int backlog);
 extern void inet_sock_destruct(struct sock *sk);
@@ -55,6 +55,7 @@ struct ipcm_cookie {
 	int			oif;
 	struct ip_options_rcu	*opt;
 	__u8			tx_flags;
+	__u16			gso_size;
 };
 
 #define IPCB(skb) ((struct inet_skb_parm*)((skb)->cb))
@@ -79,6 +80,8 @@ extern struct ip_ra_chain __rcu *ip_ra_chain;
 
 #define IP_FRAG_TIME	(30 * HZ)		/* fragment lifetime	*/
 
+#define IP_MAX_MTU	0xFFF0
+
 struct msghdr;
 struct net_device;
 struct packet_type;
@@ -19,6 +19,7 @@
 #include <linux/mutex.h>
 #include <linux/gfp.h>
 #include <linux/suspend.h>
+#include <linux/cpuset.h>
 #include <trace/events/power.h>
 
 #include "smpboot.h"
@@ -345,6 +346,76 @@ out:
 	return err;
 }
 EXPORT_SYMBOL(cpu_down);
+
+/**
+ * cpu_park - take a cpu out of scheduling without offlining it
+ * @cpu: the cpu to park
+ *
+ * The cpu is removed from cpu_active_mask and from the sched domains, and
+ * its movable tasks are pushed to the active cpus.  Unlike cpu_down() no
+ * notifier runs, stop_machine() is not needed and no per-cpu state is
+ * torn down, so the cpu just sits in its idle loop, where it can reach
+ * the deepest idle state, until cpu_unpark() is called.
+ */
+int cpu_park(unsigned int cpu)
+{
+	int err = 0;
+
+	cpu_maps_update_begin();
+
+	if (cpu_hotplug_disabled) {
+		err = -EBUSY;
+		goto out;
+	}
+
+	if (!cpu_online(cpu) || !cpu_active(cpu)) {
+		err = -EINVAL;
+		goto out;
+	}
+
+	if (num_active_cpus() == 1) {
+		err = -EBUSY;
+		goto out;
+	}
+
+	cpu_hotplug_begin();
+	set_cpu_active(cpu, false);
+	cpuset_update_active_cpus();
+	cpu_hotplug_done();
+
+	sched_park_cpu(cpu);
+out:
+	cpu_maps_update_done();
+	return err;
+}
+EXPORT_SYMBOL_GPL(cpu_park);
+
+/**
+ * cpu_unpark - make a parked cpu available to the scheduler again
+ * @cpu: the cpu to unpark
+ */
+int cpu_unpark(unsigned int cpu)
+{
+	int err = 0;
+
+	cpu_maps_update_begin();
+
+	if (!cpu_online(cpu) || cpu_active(cpu)) {
+		err = -EINVAL;
+		goto out;
+	}
+
+	sched_unpark_cpu(cpu);
+
+	cpu_hotplug_begin();
+	set_cpu_active(cpu, true);
+	cpuset_update_active_cpus();
+	cpu_hotplug_done();
+out:
+	cpu_maps_update_done();
+	return err;
+}
+EXPORT_SYMBOL_GPL(cpu_unpark);
 #endif /*CONFIG_HOTPLUG_CPU*/
 
 /* Requires cpu_add_remove_lock to be held */
@@ -13,10 +13,12 @@
  *
  */
 
+#include <linux/debugfs.h>
 #include <linux/earlysuspend.h>
 #include <linux/module.h>
 #include <linux/mutex.h>
 #include <linux/rtc.h>
+#include <linux/seq_file.h>
 #include <linux/syscalls.h> /* sys_sync */
 #include <linux/wakelock.h>
 #include <linux/workqueue.h>
@@ -48,6 +50,14 @@ static int debug_mask = DEBUG_USER_STATE|DEBUG_SUSPEND;  //[20110131:geayoung.ba
 
 module_param_named(debug_mask, debug_mask, int, S_IRUGO | S_IWUSR | S_IWGRP);
 
+/* Run the handlers of one level in parallel, with a barrier between levels */
+static bool parallel = true;
+module_param(parallel, bool, S_IRUGO | S_IWUSR | S_IWGRP);
+
+static struct workqueue_struct *early_suspend_wq;
+static unsigned int last_suspend_usecs;
+static unsigned int last_resume_usecs;
+
 static DEFINE_MUTEX(early_suspend_lock);
 static LIST_HEAD(early_suspend_handlers);
 static void early_suspend(struct work_struct *work);
@@ -71,10 +81,45 @@ static int lateResumeCount = 0;
 bool wants_display_on;
 #endif
 
+static void early_suspend_call(struct early_suspend *h)
+{
+	ktime_t start = ktime_get();
+
+	if (debug_mask & DEBUG_VERBOSE)
+		pr_info("early_suspend: calling %pf\n", h->suspend);
+	h->suspend(h);
+	h->suspend_usecs = ktime_us_delta(ktime_get(), start);
+}
+
+static void late_resume_call(struct early_suspend *h)
+{
+	ktime_t start = ktime_get();
+
+	if (debug_mask & DEBUG_VERBOSE)
+		pr_info("late_resume: calling %pf\n", h->resume);
+	h->resume(h);
+	h->resume_usecs = ktime_us_delta(ktime_get(), start);
+}
+
+static void early_suspend_call_work(struct work_struct *work)
+{
+	early_suspend_call(container_of(work, struct early_suspend,
+					suspend_work));
+}
+
+static void late_resume_call_work(struct work_struct *work)
+{
+	late_resume_call(container_of(work, struct early_suspend,
+				      resume_work));
+}
+
 void register_early_suspend(struct early_suspend *handler)
 {
 	struct list_head *pos;
 
+	INIT_WORK(&handler->suspend_work, early_suspend_call_work);
+	INIT_WORK(&handler->resume_work, late_resume_call_work);
+
 	mutex_lock(&early_suspend_lock);
 	list_for_each(pos, &early_suspend_handlers) {
 		struct early_suspend *e;
@@ -102,6 +147,9 @@ static void early_suspend(struct work_struct *work)
 	struct early_suspend *pos;
 	unsigned long irqflags;
 	int abort = 0;
+	int level = INT_MIN;
+	bool async = parallel && early_suspend_wq;
+	ktime_t start;
 
 	mutex_lock(&early_suspend_lock);
 	spin_lock_irqsave(&state_lock, irqflags);
@@ -124,11 +172,17 @@ static void early_suspend(struct work_struct *work)
 #endif
 		pr_info("early_suspend: call handlers\n");
 	}
+	start = ktime_get();
 	list_for_each_entry(pos, &early_suspend_handlers, link) {
 		if (pos->suspend != NULL) {
-			if (debug_mask & DEBUG_VERBOSE)
-				pr_info("early_suspend: calling %pf\n", pos->suspend);
-			pos->suspend(pos);
+			if (async && pos->level != level) {
+				flush_workqueue(early_suspend_wq);
+				level = pos->level;
+			}
+			if (async)
+				queue_work(early_suspend_wq, &pos->suspend_work);
+			else
+				early_suspend_call(pos);
 		}
 #if 0
 	if(charging_mode == CHARGING_NONE){
@@ -140,6 +194,9 @@ static void early_suspend(struct work_struct *work)
 	}
 #endif
 	}
+	if (async)
+		flush_workqueue(early_suspend_wq);
+	last_suspend_usecs = ktime_us_delta(ktime_get(), start);
 	mutex_unlock(&early_suspend_lock);
 
 	if (debug_mask & DEBUG_SUSPEND)
@@ -158,6 +215,9 @@ static void late_resume(struct work_struct *work)
 	struct early_suspend *pos;
 	unsigned long irqflags;
 	int abort = 0;
+	int level = INT_MAX;
+	bool async = parallel && early_suspend_wq;
+	ktime_t start;
 
 	mutex_lock(&early_suspend_lock);
 	spin_lock_irqsave(&state_lock, irqflags);
@@ -183,17 +243,25 @@ static void late_resume(struct work_struct *work)
 #endif
 		pr_info("late_resume: call handlers, wants display on\n");
 	}
+	start = ktime_get();
 	list_for_each_entry_reverse(pos, &early_suspend_handlers, link) {
 		if (pos->resume != NULL) {
-			if (debug_mask & DEBUG_VERBOSE)
-				pr_info("late_resume: calling %pf\n", pos->resume);
-
-			pos->resume(pos);
+			if (async && pos->level != level) {
+				flush_workqueue(early_suspend_wq);
+				level = pos->level;
+			}
+			if (async)
+				queue_work(early_suspend_wq, &pos->resume_work);
+			else
+				late_resume_call(pos);
 		}
 	}
+	if (async)
+		flush_workqueue(early_suspend_wq);
+	last_resume_usecs = ktime_us_delta(ktime_get(), start);
 	cpufreq_set_max_freq(NULL, LONG_MAX);
 	if (debug_mask & DEBUG_SUSPEND)
-		pr_info("late_resume: done\n");
+		pr_info("late_resume: done in %u usecs\n", last_resume_usecs);
 abort:
 	mutex_unlock(&early_suspend_lock);
 }
@@ -279,3 +347,59 @@ suspend_state_t get_suspend_state(void)
 {
 	return requested_suspend_state;
 }
+
+#ifdef CONFIG_DEBUG_FS
+static int early_suspend_timing_show(struct seq_file *m, void *unused)
+{
+	struct early_suspend *pos;
+
+	mutex_lock(&early_suspend_lock);
+	seq_printf(m, "last early_suspend %u us, late_resume %u us\n",
+		   last_suspend_usecs, last_resume_usecs);
+	seq_puts(m, "level\tsuspend_us\tresume_us\thandler\n");
+	list_for_each_entry(pos, &early_suspend_handlers, link)
+		seq_printf(m, "%d\t%u\t\t%u\t\t%pf\n", pos->level,
+			   pos->suspend_usecs, pos->resume_usecs,
+			   pos->resume ? pos->resume : pos->suspend);
+	mutex_unlock(&early_suspend_lock);
+
+	return 0;
+}
+
+static int early_suspend_timing_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, early_suspend_timing_show, NULL);
+}
+
+static const struct file_operations early_suspend_timing_fops = {
+	.owner = THIS_MODULE,
+	.open = early_suspend_timing_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init early_suspend_debugfs_init(void)
+{
+	struct dentry *d;
+
+	d = debugfs_create_file("early_suspend_timing", S_IRUGO, NULL, NULL,
+				&early_suspend_timing_fops);
+	if (IS_ERR_OR_NULL(d)) {
+		pr_warn("early_suspend: failed to create early_suspend_timing\n");
+		return d ? PTR_ERR(d) : -ENOMEM;
+	}
+	return 0;
+}
+late_initcall(early_suspend_debugfs_init);
+#endif
+
+static int __init early_suspend_init(void)
+{
+	early_suspend_wq = alloc_workqueue("early_suspend",
+					   WQ_UNBOUND | WQ_HIGHPRI, 0);
+	if (!early_suspend_wq)
+		pr_warn("early_suspend: no workqueue, handlers run serially\n");
+	return 0;
+}
+core_initcall(early_suspend_init);
@@ -14,7 +14,9 @@
  */
 
 #include <linux/module.h>
+#include <linux/percpu.h>
 #include <linux/platform_device.h>
+#include <linux/rbtree.h>
 #include <linux/rtc.h>
 #include <linux/suspend.h>
 #include <linux/syscalls.h> /* sys_sync */
@@ -22,6 +24,9 @@
 #ifdef CONFIG_WAKELOCK_STAT
 #include <linux/proc_fs.h>
 #endif
+#ifdef CONFIG_WAKELOCK_TEST
+#include <linux/delay.h>
+#endif
 #include "power.h"
 
 enum {
@@ -47,6 +52,26 @@ module_param_named(debug_mask, debug_mask, int, S_IRUGO | S_IWUSR | S_IWGRP);
 static DEFINE_SPINLOCK(list_lock);
 static LIST_HEAD(inactive_locks);
 static struct list_head active_wake_locks[WAKE_LOCK_TYPE_COUNT];
+
+/*
+ * Active locks without a timeout are only counted, locks with a timeout
+ * are kept in a tree ordered by expiry with the earliest cached, so that
+ * has_wake_lock() does not have to walk the active list.
+ */
+struct wake_lock_queue {
+	struct rb_root root;
+	struct rb_node *first;
+};
+static int active_count[WAKE_LOCK_TYPE_COUNT];
+static struct wake_lock_queue expire_queue[WAKE_LOCK_TYPE_COUNT];
+
+struct wake_lock_ops {
+	unsigned long lock;
+	unsigned long unlock;
+	unsigned long expire;
+};
+static DEFINE_PER_CPU(struct wake_lock_ops, wake_lock_ops);
+
 static int current_event_num;
 struct workqueue_struct *suspend_work_queue;
 struct wake_lock main_wake_lock;
@@ -199,14 +224,67 @@ static void update_sleep_wait_stats_locked(int done)
 #endif
 
 
+static void expire_queue_add(struct wake_lock *lock, int type)
+{
+	struct wake_lock_queue *q = &expire_queue[type];
+	struct rb_node **p = &q->root.rb_node;
+	struct rb_node *parent = NULL;
+	struct wake_lock *entry;
+	int leftmost = 1;
+
+	while (*p) {
+		parent = *p;
+		entry = rb_entry(parent, struct wake_lock, expire_node);
+		if ((long)(lock->expires - entry->expires) < 0) {
+			p = &parent->rb_left;
+		} else {
+			p = &parent->rb_right;
+			leftmost = 0;
+		}
+	}
+	if (leftmost)
+		q->first = &lock->expire_node;
+	rb_link_node(&lock->expire_node, parent, p);
+	rb_insert_color(&lock->expire_node, &q->root);
+}
+
+static void expire_queue_del(struct wake_lock *lock, int type)
+{
+	struct wake_lock_queue *q = &expire_queue[type];
+
+	if (q->first == &lock->expire_node)
+		q->first = rb_next(&lock->expire_node);
+	rb_erase(&lock->expire_node, &q->root);
+}
+
+static struct wake_lock *expire_queue_first(int type)
+{
+	struct rb_node *first = expire_queue[type].first;
+
+	return first ? rb_entry(first, struct wake_lock, expire_node) : NULL;
+}
+
+/* Drop an active lock from the count or the expire queue of its type */
+static void wake_lock_dequeue(struct wake_lock *lock, int type)
+{
+	if (!(lock->flags & WAKE_LOCK_ACTIVE))
+		return;
+	if (lock->flags & WAKE_LOCK_AUTO_EXPIRE)
+		expire_queue_del(lock, type);
+	else
+		active_count[type]--;
+}
+
 static void expire_wake_lock(struct wake_lock *lock)
 {
 #ifdef CONFIG_WAKELOCK_STAT
 	wake_unlock_stat_locked(lock, 1);
 #endif
+	wake_lock_dequeue(lock, lock->flags & WAKE_LOCK_TYPE_MASK);
 	lock->flags &= ~(WAKE_LOCK_ACTIVE | WAKE_LOCK_AUTO_EXPIRE);
 	list_del(&lock->link);
 	list_add(&lock->link, &inactive_locks);
+	__this_cpu_inc(wake_lock_ops.expire);
 	if (debug_mask & (DEBUG_WAKE_LOCK | DEBUG_EXPIRE))
 		pr_info("expired wake lock %s\n", lock->name);
 }
@@ -236,21 +314,20 @@ static void print_active_locks(int type)
 
 static long has_wake_lock_locked(int type)
 {
-	struct wake_lock *lock, *n;
-	long max_timeout = 0;
+	struct wake_lock *lock;
+	long timeout = 0;
 
 	BUG_ON(type >= WAKE_LOCK_TYPE_COUNT);
-	list_for_each_entry_safe(lock, n, &active_wake_locks[type], link) {
-		if (lock->flags & WAKE_LOCK_AUTO_EXPIRE) {
-			long timeout = lock->expires - jiffies;
-			if (timeout <= 0)
-				expire_wake_lock(lock);
-			else if (timeout > max_timeout)
-				max_timeout = timeout;
-		} else
-			return -1;
+	while ((lock = expire_queue_first(type))) {
+		timeout = lock->expires - jiffies;
+		if (timeout > 0)
+			break;
+		expire_wake_lock(lock);
+		timeout = 0;
 	}
-	return max_timeout;
+	if (active_count[type])
+		return -1;
+	return timeout;
 }
 
 long has_wake_lock(int type)
@@ -320,6 +397,8 @@ static void suspend(struct work_struct *work)
 }
 static DECLARE_WORK(suspend_work, suspend);
 
+static struct timer_list expire_timer;
+
 static void expire_wake_locks(unsigned long data)
 {
 	long has_lock;
@@ -334,6 +413,8 @@ static void expire_wake_locks(unsigned long data)
 		pr_info("expire_wake_locks: done, has_lock %ld\n", has_lock);
 	if (has_lock == 0)
 		queue_work(suspend_work_queue, &suspend_work);
+	else if (has_lock > 0)
+		mod_timer(&expire_timer, jiffies + has_lock);
 	spin_unlock_irqrestore(&list_lock, irqflags);
 }
 static DEFINE_TIMER(expire_timer, expire_wake_locks, 0, 0);
@@ -383,6 +464,7 @@ void wake_lock_init(struct wake_lock *lock, int type, const char *name)
 	lock->flags = (type & WAKE_LOCK_TYPE_MASK) | WAKE_LOCK_INITIALIZED;
 
 	INIT_LIST_HEAD(&lock->link);
+	RB_CLEAR_NODE(&lock->expire_node);
 	spin_lock_irqsave(&list_lock, irqflags);
 	list_add(&lock->link, &inactive_locks);
 	spin_unlock_irqrestore(&list_lock, irqflags);
@@ -395,7 +477,9 @@ void wake_lock_destroy(struct wake_lock *lock)
 	if (debug_mask & DEBUG_WAKE_LOCK)
 		pr_info("wake_lock_destroy name=%s\n", lock->name);
 	spin_lock_irqsave(&list_lock, irqflags);
-	lock->flags &= ~WAKE_LOCK_INITIALIZED;
+	wake_lock_dequeue(lock, lock->flags & WAKE_LOCK_TYPE_MASK);
+	lock->flags &= ~(WAKE_LOCK_INITIALIZED | WAKE_LOCK_ACTIVE |
+			 WAKE_LOCK_AUTO_EXPIRE);
 #ifdef CONFIG_WAKELOCK_STAT
 	if (lock->stat.count) {
 		deleted_wake_locks.stat.count += lock->stat.count;
@@ -440,6 +524,7 @@ static void wake_lock_internal(
 		lock->stat.last_time = ktime_get();
 	}
 #endif
+	wake_lock_dequeue(lock, type);
 	if (!(lock->flags & WAKE_LOCK_ACTIVE)) {
 		lock->flags |= WAKE_LOCK_ACTIVE;
 #ifdef CONFIG_WAKELOCK_STAT
@@ -455,13 +540,16 @@ static void wake_lock_internal(
 		lock->expires = jiffies + timeout;
 		lock->flags |= WAKE_LOCK_AUTO_EXPIRE;
 		list_add_tail(&lock->link, &active_wake_locks[type]);
+		expire_queue_add(lock, type);
 	} else {
 		if (debug_mask & DEBUG_WAKE_LOCK)
 			pr_info("wake_lock: %s, type %d\n", lock->name, type);
 		lock->expires = LONG_MAX;
 		lock->flags &= ~WAKE_LOCK_AUTO_EXPIRE;
 		list_add(&lock->link, &active_wake_locks[type]);
+		active_count[type]++;
 	}
+	__this_cpu_inc(wake_lock_ops.lock);
 	if (type == WAKE_LOCK_SUSPEND) {
 		current_event_num++;
 #ifdef CONFIG_WAKELOCK_STAT
@@ -514,9 +602,11 @@ void wake_unlock(struct wake_lock *lock)
 #endif
 	if (debug_mask & DEBUG_WAKE_LOCK)
 		pr_info("wake_unlock: %s\n", lock->name);
+	wake_lock_dequeue(lock, type);
 	lock->flags &= ~(WAKE_LOCK_ACTIVE | WAKE_LOCK_AUTO_EXPIRE);
 	list_del(&lock->link);
 	list_add(&lock->link, &inactive_locks);
+	__this_cpu_inc(wake_lock_ops.unlock);
 	if (type == WAKE_LOCK_SUSPEND) {
 		long has_lock = has_wake_lock_locked(type);
 		if (has_lock > 0) {
@@ -563,13 +653,42 @@ static const struct file_operations wakelock_stats_fops = {
 	.release = single_release,
 };
 
+static int wakelock_ops_show(struct seq_file *m, void *unused)
+{
+	struct wake_lock_ops *ops;
+	int cpu;
+
+	seq_puts(m, "cpu\tlock\tunlock\texpire\n");
+	for_each_possible_cpu(cpu) {
+		ops = &per_cpu(wake_lock_ops, cpu);
+		seq_printf(m, "%d\t%lu\t%lu\t%lu\n", cpu,
+			   ops->lock, ops->unlock, ops->expire);
+	}
+	return 0;
+}
+
+static int wakelock_ops_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, wakelock_ops_show, NULL);
+}
+
+static const struct file_operations wakelock_ops_fops = {
+	.owner = THIS_MODULE,
+	.open = wakelock_ops_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 static int __init wakelocks_init(void)
 {
 	int ret;
 	int i;
 
-	for (i = 0; i < ARRAY_SIZE(active_wake_locks); i++)
+	for (i = 0; i < ARRAY_SIZE(active_wake_locks); i++) {
 		INIT_LIST_HEAD(&active_wake_locks[i]);
+		expire_queue[i].root = RB_ROOT;
+	}
 
 #ifdef CONFIG_WAKELOCK_STAT
 	wake_lock_init(&deleted_wake_locks, WAKE_LOCK_SUSPEND,
@@ -600,6 +719,7 @@ static int __init wakelocks_init(void)
 
 #ifdef CONFIG_WAKELOCK_STAT
 	proc_create("wakelocks", S_IRUGO, NULL, &wakelock_stats_fops);
+	proc_create("wakelock_ops", S_IRUGO, NULL, &wakelock_ops_fops);
 #endif
 
 	return 0;
@@ -621,6 +741,7 @@ err_platform_device_register:
 static void  __exit wakelocks_exit(void)
 {
 #ifdef CONFIG_WAKELOCK_STAT
+	remove_proc_entry("wakelock_ops", NULL);
 	remove_proc_entry("wakelocks", NULL);
 #endif
 	destroy_workqueue(suspend_work_queue);
@@ -634,5 +755,62 @@ static void  __exit wakelocks_exit(void)
 #endif
 }
 
+#ifdef CONFIG_WAKELOCK_TEST
+/*
+ * Hold two suspend locks with different timeouts and no untimed lock, and
+ * check that the expire timer is still armed after the first one expires.
+ * main_wake_lock is dropped for the duration and taken again before the
+ * second lock expires, so this never queues a suspend.
+ */
+static struct wake_lock test_short_lock, test_long_lock;
+
+static int __init wakelocks_test(void)
+{
+	unsigned long irqflags;
+	bool main_held = wake_lock_active(&main_wake_lock);
+	int untimed;
+	int ret = 0;
+
+	wake_lock_init(&test_short_lock, WAKE_LOCK_SUSPEND, "test_short");
+	wake_lock_init(&test_long_lock, WAKE_LOCK_SUSPEND, "test_long");
+	wake_lock_timeout(&test_short_lock, HZ / 10);
+	wake_lock_timeout(&test_long_lock, 2 * HZ);
+	if (main_held)
+		wake_unlock(&main_wake_lock);
+
+	spin_lock_irqsave(&list_lock, irqflags);
+	untimed = active_count[WAKE_LOCK_SUSPEND];
+	spin_unlock_irqrestore(&list_lock, irqflags);
+	if (untimed) {
+		pr_info("wakelock test: %d untimed locks held, skipped\n",
+			untimed);
+		goto out;
+	}
+
+	msleep(jiffies_to_msecs(HZ / 10) + 100);
+
+	if (wake_lock_active(&test_short_lock) ||
+	    !wake_lock_active(&test_long_lock)) {
+		pr_err("wakelock test: short lock did not expire first\n");
+		ret = -EINVAL;
+	} else if (!timer_pending(&expire_timer)) {
+		pr_err("wakelock test: expire timer not re-armed\n");
+		ret = -EINVAL;
+	} else {
+		pr_info("wakelock test: passed\n");
+	}
+
+out:
+	if (main_held)
+		wake_lock(&main_wake_lock);
+	wake_unlock(&test_long_lock);
+	wake_unlock(&test_short_lock);
+	wake_lock_destroy(&test_long_lock);
+	wake_lock_destroy(&test_short_lock);
+	return ret;
+}
+late_initcall(wakelocks_test);
+#endif
+
 core_initcall(wakelocks_init);
 module_exit(wakelocks_exit);
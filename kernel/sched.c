@@ -605,6 +605,8 @@ struct rq {
 	#define CPU_LOAD_IDX_MAX 5
 	unsigned long cpu_load[CPU_LOAD_IDX_MAX];
 	unsigned long last_load_update_tick;
+	/* decayed busy fraction, in SCHED_POWER_SCALE units */
+	unsigned long cpu_util;
 #ifdef CONFIG_NO_HZ
 	u64 nohz_stamp;
 	unsigned long nohz_flags;
@@ -671,6 +673,16 @@ struct rq {
 	u64 age_stamp;
 	u64 idle_stamp;
 	u64 avg_idle;
+
+	/* cpu_park() state */
+	int parked;
+	int park_pending;
+	struct cpu_stop_work park_work;
+
+	/* small task packing decisions */
+	unsigned int nr_pack_wakeups;
+	unsigned int nr_pack_spread;
+	unsigned int nr_pack_holds;
 #endif
 
 #ifdef CONFIG_IRQ_TIME_ACCOUNTING
@@ -1997,11 +2009,39 @@ static void set_load_weight(struct task_struct *p)
 	load->inv_weight = prio_to_wmult[prio];
 }
 
+#ifdef CONFIG_CPU_FREQ
+static sched_freq_notify_t __rcu sched_freq_notify;
+
+/*
+ * Push a runqueue update to the cpufreq governor, if one asked for it.
+ * Called with rq->lock held, so the callback must not take any runqueue
+ * lock nor wake up tasks directly.
+ */
+static inline void sched_freq_update(struct rq *rq, unsigned int flags)
+{
+	sched_freq_notify_t fn = rcu_dereference_sched(sched_freq_notify);
+
+	if (fn)
+		fn(cpu_of(rq), rq->nr_running, flags);
+}
+
+void sched_set_freq_notifier(sched_freq_notify_t fn)
+{
+	rcu_assign_pointer(sched_freq_notify, fn);
+	if (!fn)
+		synchronize_sched();
+}
+EXPORT_SYMBOL_GPL(sched_set_freq_notifier);
+#else
+static inline void sched_freq_update(struct rq *rq, unsigned int flags) { }
+#endif
+
 static void enqueue_task(struct rq *rq, struct task_struct *p, int flags)
 {
 	update_rq_clock(rq);
 	sched_info_queued(p);
 	p->sched_class->enqueue_task(rq, p, flags);
+	sched_freq_update(rq, SCHED_FREQ_ENQUEUE);
 }
 
 static void dequeue_task(struct rq *rq, struct task_struct *p, int flags)
@@ -2009,6 +2049,7 @@ static void dequeue_task(struct rq *rq, struct task_struct *p, int flags)
 	update_rq_clock(rq);
 	sched_info_dequeued(p);
 	p->sched_class->dequeue_task(rq, p, flags);
+	sched_freq_update(rq, SCHED_FREQ_DEQUEUE);
 }
 
 static void activate_task(struct rq *rq, struct task_struct *p, int flags)
@@ -2672,6 +2713,14 @@ int select_task_rq(struct task_struct *p, int sd_flags, int wake_flags)
 		     !cpu_online(cpu)))
 		cpu = select_fallback_rq(task_cpu(p), p);
 
+	/*
+	 * Don't wake tasks up on a parked cpu, unless that is the only
+	 * place they are allowed to run.
+	 */
+	else if (unlikely(!cpu_active(cpu)) &&
+		 cpumask_intersects(tsk_cpus_allowed(p), cpu_active_mask))
+		cpu = select_fallback_rq(task_cpu(p), p);
+
 	return cpu;
 }
 
@@ -3037,6 +3086,13 @@ static void __sched_fork(struct task_struct *p)
 	p->se.vruntime			= 0;
 	INIT_LIST_HEAD(&p->se.group_node);
 
+#ifdef CONFIG_SMP
+	/* Unknown tasks are treated as big until they have been sampled */
+	p->se.pack_stamp		= 0;
+	p->se.pack_exec			= 0;
+	p->se.pack_util			= SCHED_POWER_SCALE;
+#endif
+
 #ifdef CONFIG_SCHEDSTATS
 	memset(&p->se.statistics, 0, sizeof(p->se.statistics));
 #endif
@@ -3832,6 +3888,9 @@ decay_load_missed(unsigned long load, unsigned long missed_updates, int idx)
 	return load;
 }
 
+/* rq->cpu_util decays by 7/8 per tick */
+#define CPU_UTIL_IDX		3
+
 /*
  * Update rq->cpu_load[] statistics. This function is usually called every
  * scheduler tick (TICK_NSEC). With tickless idle this will not be called
@@ -3842,6 +3901,7 @@ static void update_cpu_load(struct rq *this_rq)
 	unsigned long this_load = this_rq->load.weight;
 	unsigned long curr_jiffies = jiffies;
 	unsigned long pending_updates;
+	unsigned long old_util, new_util;
 	int i, scale;
 
 	this_rq->nr_load_updates++;
@@ -3874,6 +3934,16 @@ static void update_cpu_load(struct rq *this_rq)
 		this_rq->cpu_load[i] = (old_load * (scale - 1) + new_load) >> i;
 	}
 
+	/*
+	 * Busy fraction, sampled once per tick and averaged like
+	 * cpu_load[CPU_UTIL_IDX]. Missed ticks were spent idle.
+	 */
+	old_util = decay_load_missed(this_rq->cpu_util, pending_updates - 1,
+				     CPU_UTIL_IDX);
+	new_util = this_rq->nr_running ? SCHED_POWER_SCALE : 0;
+	this_rq->cpu_util = (old_util * ((1 << CPU_UTIL_IDX) - 1) + new_util)
+				>> CPU_UTIL_IDX;
+
 	sched_avg_update(this_rq);
 }
 
@@ -3882,6 +3952,7 @@ static void update_cpu_load_active(struct rq *this_rq)
 	update_cpu_load(this_rq);
 
 	calc_load_account_active(this_rq);
+	sched_freq_update(this_rq, SCHED_FREQ_TICK);
 }
 
 #ifdef CONFIG_SMP
@@ -4354,6 +4425,12 @@ void thread_group_times(struct task_struct *p, cputime_t *ut, cputime_t *st)
  * This function gets called by the timer code, with HZ frequency.
  * We call it with interrupts disabled.
  */
+#if defined(CONFIG_SMP) && defined(CONFIG_HOTPLUG_CPU)
+static void park_tick(struct rq *rq, int cpu);
+#else
+static inline void park_tick(struct rq *rq, int cpu) { }
+#endif
+
 void scheduler_tick(void)
 {
 	int cpu = smp_processor_id();
@@ -4374,6 +4451,7 @@ void scheduler_tick(void)
 	rq->idle_balance = idle_cpu(cpu);
 	trigger_load_balance(rq, cpu);
 #endif
+	park_tick(rq, cpu);
 }
 
 notrace unsigned long get_parent_ip(unsigned long addr)
@@ -6578,6 +6656,84 @@ static void migrate_tasks(unsigned int dead_cpu)
 	rq->stop = stop;
 }
 
+/*
+ * Push the runnable tasks off a parked cpu.  Runs in the stopper thread of
+ * that cpu, so like migrate_tasks() it hides the stop task from the pick
+ * loop.  The loop ends at the first task that may only run on this cpu;
+ * the remaining ones are pushed from park_tick() once it has run.
+ */
+static int park_cpu_stop(void *data)
+{
+	unsigned int cpu = smp_processor_id();
+	struct rq *rq = cpu_rq(cpu);
+	struct task_struct *next, *stop = rq->stop;
+	int dest_cpu;
+
+	local_irq_disable();
+	raw_spin_lock(&rq->lock);
+	rq->park_pending = 0;
+
+	if (!rq->parked || cpu_active(cpu))
+		goto out;
+
+	rq->stop = NULL;
+	while (rq->nr_running > 1) {
+		next = pick_next_task(rq);
+		BUG_ON(!next);
+		next->sched_class->put_prev_task(rq, next);
+
+		if (!cpumask_intersects(tsk_cpus_allowed(next),
+					cpu_active_mask))
+			break;
+
+		dest_cpu = select_fallback_rq(cpu, next);
+		raw_spin_unlock(&rq->lock);
+
+		__migrate_task(next, cpu, dest_cpu);
+
+		raw_spin_lock(&rq->lock);
+	}
+	rq->stop = stop;
+out:
+	raw_spin_unlock(&rq->lock);
+	local_irq_enable();
+	return 0;
+}
+
+/* Called from the tick of @cpu, push a movable current task away. */
+static void park_tick(struct rq *rq, int cpu)
+{
+	struct task_struct *curr = rq->curr;
+
+	if (likely(!rq->parked) || cpu_active(cpu) || rq->park_pending)
+		return;
+
+	if (curr == rq->idle ||
+	    !cpumask_intersects(tsk_cpus_allowed(curr), cpu_active_mask))
+		return;
+
+	rq->park_pending = 1;
+	stop_one_cpu_nowait(cpu, park_cpu_stop, NULL, &rq->park_work);
+}
+
+/*
+ * Called by cpu_park() once @cpu has been removed from cpu_active_mask
+ * and the sched domains, with the cpu maps lock held.
+ */
+void sched_park_cpu(unsigned int cpu)
+{
+	struct rq *rq = cpu_rq(cpu);
+
+	rq->parked = 1;
+	rq->park_pending = 0;
+	stop_one_cpu(cpu, park_cpu_stop, NULL);
+}
+
+void sched_unpark_cpu(unsigned int cpu)
+{
+	cpu_rq(cpu)->parked = 0;
+}
+
 #endif /* CONFIG_HOTPLUG_CPU */
 
 #if defined(CONFIG_SCHED_DEBUG) && defined(CONFIG_SYSCTL)
@@ -277,6 +277,12 @@ static void print_cpu(struct seq_file *m, int cpu)
 	P(cpu_load[2]);
 	P(cpu_load[3]);
 	P(cpu_load[4]);
+	P(cpu_util);
+#ifdef CONFIG_SMP
+	P(nr_pack_wakeups);
+	P(nr_pack_spread);
+	P(nr_pack_holds);
+#endif
 #undef P
 #undef PN
 
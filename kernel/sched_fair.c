@@ -103,6 +103,19 @@ unsigned int __read_mostly sysctl_sched_shares_window = 10000000UL;
 unsigned int sysctl_sched_cfs_bandwidth_slice = 5000UL;
 #endif
 
+#ifdef CONFIG_SMP
+/*
+ * Small task packing: wake tasks using less than sched_pack_small_pct of a
+ * cpu onto a cpu that is already busy, as long as that cpu stays below
+ * sched_pack_threshold_pct, and keep idle cpus from pulling them apart
+ * again. This leaves the other cores idle long enough to be taken offline.
+ * (default: off)
+ */
+unsigned int sysctl_sched_pack_small_tasks __read_mostly;
+unsigned int sysctl_sched_pack_small_pct __read_mostly = 20;
+unsigned int sysctl_sched_pack_threshold_pct __read_mostly = 80;
+#endif
+
 static const struct sched_class fair_sched_class;
 
 /**************************************************************
@@ -2296,6 +2309,90 @@ static int select_idle_sibling(struct task_struct *p, int target)
 	return target;
 }
 
+/*
+ * Sample the fraction of wall time @p spent running since the last sample.
+ * Only called at wakeup, so a task that sleeps a lot is cheap to track.
+ */
+static unsigned long task_pack_util(struct task_struct *p)
+{
+	struct sched_entity *se = &p->se;
+	u64 now = sched_clock_cpu(smp_processor_id());
+	u64 wall, exec;
+
+	if (!se->pack_stamp)
+		goto restart;
+
+	wall = now - se->pack_stamp;
+	if ((s64)wall < NSEC_PER_MSEC)
+		return se->pack_util;
+
+	exec = min(se->sum_exec_runtime - se->pack_exec, wall);
+	se->pack_util = (se->pack_util * 3 +
+			 div64_u64(exec << SCHED_POWER_SHIFT, wall)) >> 2;
+restart:
+	se->pack_stamp = now;
+	se->pack_exec = se->sum_exec_runtime;
+
+	return se->pack_util;
+}
+
+static inline int pack_util_fits(unsigned long util, unsigned int pct)
+{
+	return util * 100 <= pct * SCHED_POWER_SCALE;
+}
+
+/*
+ * Pick the busiest active cpu that can still take @p without going over
+ * the packing threshold, or -1 if @p is not small or nothing fits.
+ */
+static int select_pack_cpu(struct task_struct *p, int prev_cpu)
+{
+	unsigned long task_util, util, best_util = 0;
+	int i, best = -1;
+
+	task_util = task_pack_util(p);
+	if (!pack_util_fits(task_util, sysctl_sched_pack_small_pct))
+		return -1;
+
+	for_each_cpu_and(i, tsk_cpus_allowed(p), cpu_active_mask) {
+		struct rq *rq = cpu_rq(i);
+
+		if (!rq->nr_running)
+			continue;
+
+		util = rq->cpu_util + task_util;
+		if (!pack_util_fits(util, sysctl_sched_pack_threshold_pct))
+			continue;
+
+		/* Best fit, prefer prev_cpu on a tie for its cache */
+		if (best < 0 || util > best_util ||
+		    (util == best_util && i == prev_cpu)) {
+			best = i;
+			best_util = util;
+		}
+	}
+
+	if (best < 0)
+		this_rq()->nr_pack_spread++;
+	else
+		cpu_rq(best)->nr_pack_wakeups++;
+
+	return best;
+}
+
+/*
+ * Should an idle cpu leave the tasks of @busiest alone? True while the
+ * packing policy is on and @busiest still has headroom.
+ */
+static inline int pack_hold(struct rq *busiest, enum cpu_idle_type idle)
+{
+	if (!sysctl_sched_pack_small_tasks || idle == CPU_NOT_IDLE)
+		return 0;
+
+	return pack_util_fits(busiest->cpu_util,
+			      sysctl_sched_pack_threshold_pct);
+}
+
 /*
  * sched_balance_self: balance the current task (running on cpu) in domains
  * that have the 'flag' flag set. In practice, this is SD_BALANCE_FORK and
@@ -2319,6 +2416,11 @@ select_task_rq_fair(struct task_struct *p, int sd_flag, int wake_flags)
 	int sync = wake_flags & WF_SYNC;
 
 	if (sd_flag & SD_BALANCE_WAKE) {
+		if (sysctl_sched_pack_small_tasks) {
+			new_cpu = select_pack_cpu(p, prev_cpu);
+			if (new_cpu >= 0)
+				return new_cpu;
+		}
 		if (cpumask_test_cpu(cpu, tsk_cpus_allowed(p)))
 			want_affine = 1;
 		new_cpu = prev_cpu;
@@ -4042,6 +4144,11 @@ redo:
 
 	BUG_ON(busiest == this_rq);
 
+	if (pack_hold(busiest, idle)) {
+		busiest->nr_pack_holds++;
+		goto out_balanced;
+	}
+
 	schedstat_add(sd, lb_imbalance[idle], imbalance);
 
 	ld_moved = 0;
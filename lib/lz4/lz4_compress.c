@@ -0,0 +1,111 @@
+/*
+ *  LZ4 - Fast LZ compression algorithm, block format
+ *
+ *  A single pass over the input with a 4096 entry hash table of the
+ *  last position each 4 byte sequence was seen at. Positions that do
+ *  not find a match make the scan skip ahead faster, so incompressible
+ *  data costs little more than a copy.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ */
+
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+#include <asm/unaligned.h>
+#include <linux/lz4.h>
+#include "lz4defs.h"
+
+static inline u32 lz4_hash_pos(const u8 *p)
+{
+	return lz4_hash(READ32(p), HASH_LOG);
+}
+
+int lz4_compress(const unsigned char *src, size_t src_len,
+		 unsigned char *dst, size_t *dst_len, void *wrkmem)
+{
+	u32 *table = wrkmem;
+	const u8 *ip = src;
+	const u8 *anchor = src;
+	const u8 * const iend = src + src_len;
+	const u8 * const mflimit = iend - MFLIMIT;
+	const u8 * const matchlimit = iend - LASTLITERALS;
+	u8 *op = dst;
+	u8 * const oend = dst + *dst_len;
+	const u8 *ref;
+	u32 forward_h;
+
+	if (src_len < MINLENGTH)
+		goto last_literals;
+
+	memset(table, 0, LZ4_MEM_COMPRESS);
+
+	table[lz4_hash_pos(ip)] = 0;
+	ip++;
+	forward_h = lz4_hash_pos(ip);
+
+	for (;;) {
+		unsigned int attempts = (1U << SKIPSTRENGTH) + 3;
+		const u8 *forward_ip = ip;
+		size_t ml;
+
+		/* find a match */
+		do {
+			u32 h = forward_h;
+
+			ip = forward_ip;
+			forward_ip = ip + (attempts++ >> SKIPSTRENGTH);
+			if (unlikely(forward_ip > mflimit))
+				goto last_literals;
+
+			forward_h = lz4_hash_pos(forward_ip);
+			ref = src + table[h];
+			table[h] = ip - src;
+		} while (ip - ref > MAX_DISTANCE || READ32(ref) != READ32(ip));
+
+		/* extend it backwards */
+		while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+			ip--;
+			ref--;
+		}
+
+		for (;;) {
+			ml = MINMATCH + lz4_count(ip + MINMATCH, ref + MINMATCH,
+						  matchlimit);
+			op = lz4_encode_sequence(op, oend, anchor, ip, ref, ml);
+			if (!op)
+				return -ENOSPC;
+			ip += ml;
+			anchor = ip;
+
+			if (ip > mflimit)
+				goto last_literals;
+
+			table[lz4_hash_pos(ip - 2)] = ip - 2 - src;
+
+			/* is there a match right away? */
+			forward_h = lz4_hash_pos(ip);
+			ref = src + table[forward_h];
+			table[forward_h] = ip - src;
+			if (ip - ref > MAX_DISTANCE || READ32(ref) != READ32(ip))
+				break;
+		}
+
+		ip++;
+		forward_h = lz4_hash_pos(ip);
+	}
+
+last_literals:
+	op = lz4_encode_last_literals(op, oend, anchor, iend);
+	if (!op)
+		return -ENOSPC;
+
+	*dst_len = op - dst;
+	return 0;
+}
+EXPORT_SYMBOL_GPL(lz4_compress);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("LZ4 compressor");
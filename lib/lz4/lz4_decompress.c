@@ -0,0 +1,149 @@
+/*
+ *  LZ4 Decompressor, block format
+ *
+ *  Both entry points check every length and offset against the
+ *  buffers they were given, so corrupt or malicious input can not
+ *  make them read or write out of bounds. Literals and matches are
+ *  copied 8 bytes at a time while there is room for the overshoot,
+ *  and byte by byte close to the end of the buffers.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ */
+
+#ifndef STATIC
+#include <linux/module.h>
+#include <linux/kernel.h>
+#endif
+#include <linux/string.h>
+#include <asm/unaligned.h>
+#include <linux/lz4.h>
+#include "lz4defs.h"
+
+/* extended length: a run of 255 bytes ended by a smaller one */
+static inline int lz4_read_length(const u8 **ipp, const u8 *iend,
+				  size_t *len)
+{
+	const u8 *ip = *ipp;
+	unsigned int s;
+
+	do {
+		if (unlikely(ip >= iend))
+			return -1;
+		s = *ip++;
+		*len += s;
+	} while (s == 255);
+	*ipp = ip;
+	return 0;
+}
+
+/*
+ * Decode sequences until the input runs out or, with fill set, until
+ * the output buffer is full. On success *src_len and *dst_len are
+ * updated to the bytes consumed and produced.
+ */
+static int lz4_uncompress(const u8 *src, size_t *src_len,
+			  u8 *dst, size_t *dst_len, bool fill)
+{
+	const u8 *ip = src;
+	const u8 * const iend = src + *src_len;
+	u8 *op = dst;
+	u8 * const oend = dst + *dst_len;
+
+	for (;;) {
+		unsigned int token;
+		size_t length, offset;
+		const u8 *ref;
+
+		if (unlikely(ip >= iend))
+			return -EINVAL;
+		token = *ip++;
+
+		/* literals */
+		length = token >> ML_BITS;
+		if (length == RUN_MASK && lz4_read_length(&ip, iend, &length))
+			return -EINVAL;
+		if (unlikely(length > (size_t)(iend - ip) ||
+			     length > (size_t)(oend - op)))
+			return -EINVAL;
+		if (length <= 2 * COPYLENGTH &&
+		    iend - ip >= 2 * COPYLENGTH &&
+		    oend - op >= 2 * COPYLENGTH) {
+			COPY8(op, ip);
+			COPY8(op + COPYLENGTH, ip + COPYLENGTH);
+		} else
+			memcpy(op, ip, length);
+		ip += length;
+		op += length;
+
+		/* the block ends with literals */
+		if (ip == iend || (fill && op == oend))
+			break;
+
+		/* match */
+		if (unlikely(iend - ip < 2))
+			return -EINVAL;
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (unlikely(!offset || offset > (size_t)(op - dst)))
+			return -EINVAL;
+		ref = op - offset;
+
+		length = token & ML_MASK;
+		if (length == ML_MASK && lz4_read_length(&ip, iend, &length))
+			return -EINVAL;
+		length += MINMATCH;
+		if (unlikely(length > (size_t)(oend - op)))
+			return -EINVAL;
+
+		if (offset >= COPYLENGTH &&
+		    length + COPYLENGTH <= (size_t)(oend - op)) {
+			u8 * const cpy = op + length;
+
+			do {
+				COPY8(op, ref);
+				op += COPYLENGTH;
+				ref += COPYLENGTH;
+			} while (op < cpy);
+			op = cpy;
+		} else {
+			/* overlapping: the match repeats its last offset bytes */
+			while (length--)
+				*op++ = *ref++;
+		}
+	}
+
+	*src_len = ip - src;
+	*dst_len = op - dst;
+	return 0;
+}
+
+int lz4_decompress(const unsigned char *src, size_t *src_len,
+		   unsigned char *dest, size_t actual_dest_len)
+{
+	size_t len = actual_dest_len;
+	int ret;
+
+	ret = lz4_uncompress(src, src_len, dest, &len, true);
+	if (ret)
+		return ret;
+	if (len != actual_dest_len)
+		return -EINVAL;
+	return 0;
+}
+#ifndef STATIC
+EXPORT_SYMBOL(lz4_decompress);
+#endif
+
+int lz4_decompress_unknownoutputsize(const unsigned char *src, size_t src_len,
+				     unsigned char *dest, size_t *dest_len)
+{
+	return lz4_uncompress(src, &src_len, dest, dest_len, false);
+}
+#ifndef STATIC
+EXPORT_SYMBOL(lz4_decompress_unknownoutputsize);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("LZ4 Decompressor");
+#endif
@@ -0,0 +1,155 @@
+/*
+ *  lz4defs.h -- common and architecture specific defines for the kernel
+ *  LZ4 compressors and decompressor
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ */
+
+#if defined(__arm__) && ((__LINUX_ARM_ARCH__ >= 6) || defined(__ARM_FEATURE_UNALIGNED))
+#define COPY4(dst, src)	\
+		* (u32 *) (void *) (dst) = * (const u32 *) (const void *) (src)
+#define READ32(p)	(* (const u32 *) (const void *) (p))
+#else
+#define COPY4(dst, src)	\
+		put_unaligned(get_unaligned((const u32 *)(src)), (u32 *)(dst))
+#define READ32(p)	get_unaligned((const u32 *)(p))
+#endif
+#if defined(__x86_64__)
+#define COPY8(dst, src)	\
+		put_unaligned(get_unaligned((const u64 *)(src)), (u64 *)(dst))
+#else
+#define COPY8(dst, src)	\
+		COPY4(dst, src); COPY4((dst) + 4, (src) + 4)
+#endif
+#define READLONG(p)	get_unaligned((const unsigned long *)(p))
+
+#define MINMATCH	4
+#define COPYLENGTH	8
+#define LASTLITERALS	5
+#define MFLIMIT		(COPYLENGTH + MINMATCH)
+#define MINLENGTH	(MFLIMIT + 1)
+
+#define MAXD_LOG	16
+#define MAX_DISTANCE	((1 << MAXD_LOG) - 1)
+
+#define ML_BITS		4
+#define ML_MASK		((1U << ML_BITS) - 1)
+#define RUN_BITS	(8 - ML_BITS)
+#define RUN_MASK	((1U << RUN_BITS) - 1)
+
+/* lz4_compress() */
+#define HASH_LOG	12
+#define SKIPSTRENGTH	6
+
+/* lz4hc_compress() */
+#define HASHHC_LOG	15
+#define MAXD_MASK	((1 << MAXD_LOG) - 1)
+#define MAX_NB_ATTEMPTS	256
+
+static inline u32 lz4_hash(u32 seq, int log)
+{
+	return (seq * 2654435761U) >> (32 - log);
+}
+
+/* number of leading bytes a and b have in common, given a ^ b != 0 */
+static inline unsigned int lz4_nb_common_bytes(unsigned long diff)
+{
+#ifdef __LITTLE_ENDIAN
+	return __ffs(diff) >> 3;
+#else
+	return (BITS_PER_LONG - 1 - __fls(diff)) >> 3;
+#endif
+}
+
+/* length of the common run at p and ref, p < limit; ref must be below p */
+static inline size_t lz4_count(const u8 *p, const u8 *ref, const u8 *limit)
+{
+	const u8 *start = p;
+
+	while (p + sizeof(unsigned long) <= limit) {
+		unsigned long diff = READLONG(ref) ^ READLONG(p);
+
+		if (diff)
+			return p - start + lz4_nb_common_bytes(diff);
+		p += sizeof(unsigned long);
+		ref += sizeof(unsigned long);
+	}
+	while (p < limit && *ref == *p) {
+		p++;
+		ref++;
+	}
+	return p - start;
+}
+
+/* bytes needed to encode the part of a length that overflows its token */
+static inline size_t lz4_length_bytes(size_t len, unsigned int mask)
+{
+	return len < mask ? 0 : (len - mask) / 255 + 1;
+}
+
+static inline u8 *lz4_write_length(u8 *op, size_t len)
+{
+	for (; len >= 255; len -= 255)
+		*op++ = 255;
+	*op++ = (u8)len;
+	return op;
+}
+
+/*
+ * Append one sequence: the literals from anchor up to ip, then, if
+ * ml != 0, a match of ml bytes at distance ip - ref. Returns the new
+ * output position, or NULL if it would not leave room in [op, oend)
+ * for the last literals.
+ */
+static inline u8 *lz4_encode_sequence(u8 *op, u8 *oend, const u8 *anchor,
+				      const u8 *ip, const u8 *ref, size_t ml)
+{
+	size_t lit = ip - anchor;
+	u8 *token = op++;
+	size_t need;
+
+	need = lit + lz4_length_bytes(lit, RUN_MASK) + 2 +
+	       lz4_length_bytes(ml - MINMATCH, ML_MASK) + 1 + LASTLITERALS;
+	if (need > (size_t)(oend - op))
+		return NULL;
+
+	if (lit >= RUN_MASK) {
+		*token = RUN_MASK << ML_BITS;
+		op = lz4_write_length(op, lit - RUN_MASK);
+	} else
+		*token = lit << ML_BITS;
+	memcpy(op, anchor, lit);
+	op += lit;
+
+	*op++ = (u8)(ip - ref);
+	*op++ = (u8)((ip - ref) >> 8);
+
+	ml -= MINMATCH;
+	if (ml >= ML_MASK) {
+		*token |= ML_MASK;
+		op = lz4_write_length(op, ml - ML_MASK);
+	} else
+		*token |= ml;
+
+	return op;
+}
+
+/* the block ends with the literals from anchor up to iend */
+static inline u8 *lz4_encode_last_literals(u8 *op, u8 *oend,
+					   const u8 *anchor, const u8 *iend)
+{
+	size_t lit = iend - anchor;
+
+	if (1 + lz4_length_bytes(lit, RUN_MASK) + lit > (size_t)(oend - op))
+		return NULL;
+
+	if (lit >= RUN_MASK) {
+		*op++ = RUN_MASK << ML_BITS;
+		op = lz4_write_length(op, lit - RUN_MASK);
+	} else
+		*op++ = lit << ML_BITS;
+	memcpy(op, anchor, lit);
+	return op + lit;
+}
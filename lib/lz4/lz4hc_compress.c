@@ -0,0 +1,158 @@
+/*
+ *  LZ4 HC - High Compression mode of LZ4, block format
+ *
+ *  Every position is entered in a hash chain, and each match is the
+ *  longest of up to MAX_NB_ATTEMPTS candidates within the 64KB window.
+ *  A match is only taken once the next position has been checked for
+ *  a longer one (lazy matching). The output is plain LZ4 and
+ *  decompresses as fast as that of lz4_compress().
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ */
+
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+#include <asm/unaligned.h>
+#include <linux/lz4.h>
+#include "lz4defs.h"
+
+struct lz4hc_data {
+	u32 hash_table[1 << HASHHC_LOG];
+	u16 chain_table[1 << MAXD_LOG];	/* distance to previous, 0: none */
+};
+
+struct lz4hc_state {
+	struct lz4hc_data *data;
+	const u8 *base;
+	const u8 *next_to_update;
+};
+
+static inline u32 lz4hc_hash_pos(const u8 *p)
+{
+	return lz4_hash(READ32(p), HASHHC_LOG);
+}
+
+/* enter every position below ip in the hash chains */
+static inline void lz4hc_insert(struct lz4hc_state *s, const u8 *ip)
+{
+	struct lz4hc_data *d = s->data;
+	const u8 *p = s->next_to_update;
+
+	while (p < ip) {
+		u32 h = lz4hc_hash_pos(p);
+		size_t pos = p - s->base;
+		size_t delta = pos - d->hash_table[h];
+
+		if (delta > MAX_DISTANCE || !d->hash_table[h])
+			delta = 0;
+		d->chain_table[pos & MAXD_MASK] = delta;
+		d->hash_table[h] = pos;
+		p++;
+	}
+	s->next_to_update = p;
+}
+
+/* the longest match for ip ending no later than matchlimit, or 0 */
+static size_t lz4hc_find_longest_match(struct lz4hc_state *s, const u8 *ip,
+				       const u8 *matchlimit, const u8 **matchpos)
+{
+	struct lz4hc_data *d = s->data;
+	int attempts = MAX_NB_ATTEMPTS;
+	size_t ml = 0;
+	const u8 *ref;
+
+	lz4hc_insert(s, ip);
+	ref = s->base + d->hash_table[lz4hc_hash_pos(ip)];
+
+	while (ref < ip && ip - ref <= MAX_DISTANCE && attempts--) {
+		u16 delta;
+
+		if (ref[ml] == ip[ml] && READ32(ref) == READ32(ip)) {
+			size_t len = MINMATCH + lz4_count(ip + MINMATCH,
+							  ref + MINMATCH,
+							  matchlimit);
+
+			if (len > ml) {
+				ml = len;
+				*matchpos = ref;
+			}
+		}
+
+		delta = d->chain_table[(ref - s->base) & MAXD_MASK];
+		if (!delta)
+			break;
+		ref -= delta;
+	}
+	return ml;
+}
+
+int lz4hc_compress(const unsigned char *src, size_t src_len,
+		   unsigned char *dst, size_t *dst_len, void *wrkmem)
+{
+	struct lz4hc_state s;
+	const u8 *ip = src;
+	const u8 *anchor = src;
+	const u8 * const iend = src + src_len;
+	const u8 * const mflimit = iend - MFLIMIT;
+	const u8 * const matchlimit = iend - LASTLITERALS;
+	u8 *op = dst;
+	u8 * const oend = dst + *dst_len;
+
+	if (src_len < MINLENGTH)
+		goto last_literals;
+
+	s.data = wrkmem;
+	s.base = src;
+	s.next_to_update = src;
+	memset(s.data->hash_table, 0, sizeof(s.data->hash_table));
+
+	ip++;
+	while (ip <= mflimit) {
+		const u8 *ref, *ref2;
+		size_t ml, ml2;
+
+		ml = lz4hc_find_longest_match(&s, ip, matchlimit, &ref);
+		if (!ml) {
+			ip++;
+			continue;
+		}
+
+		/* a longer match one byte further on is worth a literal */
+		while (ip + 1 <= mflimit) {
+			ml2 = lz4hc_find_longest_match(&s, ip + 1, matchlimit,
+						       &ref2);
+			if (ml2 <= ml)
+				break;
+			ip++;
+			ml = ml2;
+			ref = ref2;
+		}
+
+		while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+			ip--;
+			ref--;
+			ml++;
+		}
+
+		op = lz4_encode_sequence(op, oend, anchor, ip, ref, ml);
+		if (!op)
+			return -ENOSPC;
+		ip += ml;
+		anchor = ip;
+	}
+
+last_literals:
+	op = lz4_encode_last_literals(op, oend, anchor, iend);
+	if (!op)
+		return -ENOSPC;
+
+	*dst_len = op - dst;
+	return 0;
+}
+EXPORT_SYMBOL_GPL(lz4hc_compress);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("LZ4HC compressor");
@@ -87,13 +87,9 @@ copy_literal_run:
 					unsigned char *oe = op + t;
 					do {
 						COPY8(op, ip);
-						op += 8;
-						ip += 8;
-#  if !defined(__arm__)
-						COPY8(op, ip);
-						op += 8;
-						ip += 8;
-#  endif
+						COPY8(op + 8, ip + 8);
+						op += 16;
+						ip += 16;
 					} while (ip < ie);
 					ip = ie;
 					op = oe;
@@ -190,13 +186,9 @@ copy_literal_run:
 			if (likely(HAVE_OP(t + 15))) {
 				do {
 					COPY8(op, m_pos);
-					op += 8;
-					m_pos += 8;
-#  if !defined(__arm__)
-					COPY8(op, m_pos);
-					op += 8;
-					m_pos += 8;
-#  endif
+					COPY8(op + 8, m_pos + 8);
+					op += 16;
+					m_pos += 16;
 				} while (op < oe);
 				op = oe;
 				if (HAVE_IP(6)) {
@@ -212,6 +204,15 @@ copy_literal_run:
 					*op++ = *m_pos++;
 				} while (op < oe);
 			}
+		} else if (op - m_pos >= 4 && likely(HAVE_OP(t + 3))) {
+			/* short distance: each word read was written already */
+			unsigned char *oe = op + t;
+			do {
+				COPY4(op, m_pos);
+				op += 4;
+				m_pos += 4;
+			} while (op < oe);
+			op = oe;
 		} else
 #endif
 		{
@@ -0,0 +1,160 @@
+/*
+ * Fuzz lzo1x_decompress_safe() with the output of lzo1x_1_compress().
+ *
+ * Every round compresses a pseudo-random buffer, checks that it
+ * decompresses back unchanged, then feeds corrupted and truncated
+ * versions of it to the decompressor with output buffers of random
+ * size. Inputs and outputs are placed at the very end of vmalloc
+ * areas, so that any read or write past the buffers handed to the
+ * decompressor faults on the guard page instead of going unnoticed.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/random.h>
+#include <linux/vmalloc.h>
+#include <linux/lzo.h>
+
+#define TEST_LZO_MAX_LEN	(4 * PAGE_SIZE)
+#define TEST_LZO_COMP_LEN	PAGE_ALIGN(lzo1x_worst_compress(TEST_LZO_MAX_LEN))
+
+static unsigned int rounds = 1000;
+module_param(rounds, uint, 0444);
+MODULE_PARM_DESC(rounds, "number of buffers to compress and mangle");
+
+static struct rnd_state rnd;
+static unsigned char *src, *comp, *in_area, *out_area;
+static void *wrkmem;
+
+static u32 __init test_lzo_rand(u32 n)
+{
+	return n ? prandom_u32_state(&rnd) % n : 0;
+}
+
+/* mostly repetitive data with literal runs, like a typical page */
+static void __init test_lzo_fill(unsigned char *p, size_t len)
+{
+	u32 dist = 1 + test_lzo_rand(64);
+	u32 noise = test_lzo_rand(8);
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if (i < dist || test_lzo_rand(8) < noise)
+			p[i] = prandom_u32_state(&rnd);
+		else
+			p[i] = p[i - dist];
+	}
+}
+
+static int __init test_lzo_decompress(const unsigned char *in, size_t in_len,
+				      size_t out_len, size_t *res_len)
+{
+	/* both buffers end exactly at a guard page */
+	unsigned char *ip = in_area + TEST_LZO_COMP_LEN - in_len;
+	unsigned char *op = out_area + TEST_LZO_MAX_LEN - out_len;
+	int ret;
+
+	memcpy(ip, in, in_len);
+	*res_len = out_len;
+	ret = lzo1x_decompress_safe(ip, in_len, op, res_len);
+	if (*res_len > out_len) {
+		pr_err("test_lzo: reported %zu bytes out of a %zu byte buffer\n",
+		       *res_len, out_len);
+		return LZO_E_ERROR;
+	}
+	return ret;
+}
+
+static int __init test_lzo_round(void)
+{
+	size_t len = test_lzo_rand(TEST_LZO_MAX_LEN + 1);
+	size_t clen, res_len, i;
+	int ret;
+
+	test_lzo_fill(src, len);
+
+	ret = lzo1x_1_compress(src, len, comp, &clen, wrkmem);
+	if (ret != LZO_E_OK) {
+		pr_err("test_lzo: compression of %zu bytes failed: %d\n",
+		       len, ret);
+		return -EINVAL;
+	}
+
+	ret = test_lzo_decompress(comp, clen, len, &res_len);
+	if (ret != LZO_E_OK || res_len != len ||
+	    memcmp(out_area + TEST_LZO_MAX_LEN - len, src, len)) {
+		pr_err("test_lzo: %zu -> %zu bytes does not round trip: %d\n",
+		       len, clen, ret);
+		return -EINVAL;
+	}
+
+	/* whatever the damage, the decompressor has to stay in bounds */
+	for (i = 0; i < 8; i++) {
+		size_t in_len = clen, out_len = len;
+
+		switch (test_lzo_rand(3)) {
+		case 0:
+			comp[test_lzo_rand(clen)] = prandom_u32_state(&rnd);
+			break;
+		case 1:
+			in_len = test_lzo_rand(clen + 1);
+			break;
+		case 2:
+			out_len = test_lzo_rand(len + 1);
+			break;
+		}
+		test_lzo_decompress(comp, in_len, out_len, &res_len);
+		if (res_len > out_len)
+			return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int __init test_lzo_init(void)
+{
+	unsigned int i;
+	int ret = -ENOMEM;
+
+	src = vmalloc(TEST_LZO_MAX_LEN);
+	comp = vmalloc(TEST_LZO_COMP_LEN);
+	in_area = vmalloc(TEST_LZO_COMP_LEN);
+	out_area = vmalloc(TEST_LZO_MAX_LEN);
+	wrkmem = vmalloc(LZO1X_MEM_COMPRESS);
+	if (!src || !comp || !in_area || !out_area || !wrkmem)
+		goto out;
+
+	prandom_seed_state(&rnd, 3141592653589793238ULL);
+
+	for (i = 0; i < rounds; i++) {
+		ret = test_lzo_round();
+		if (ret)
+			break;
+	}
+
+	if (ret)
+		pr_err("test_lzo: failed in round %u\n", i);
+	else
+		pr_info("test_lzo: %u rounds passed\n", rounds);
+out:
+	vfree(wrkmem);
+	vfree(out_area);
+	vfree(in_area);
+	vfree(comp);
+	vfree(src);
+	return ret;
+}
+
+static void __exit test_lzo_exit(void)
+{
+}
+
+module_init(test_lzo_init);
+module_exit(test_lzo_exit);
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("LZO1X decompressor fuzz test");
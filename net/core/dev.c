@@ -123,6 +123,7 @@
 #include <linux/if_vlan.h>
 #include <linux/ip.h>
 #include <net/ip.h>
+#include <net/busy_poll.h>
 #include <linux/ipv6.h>
 #include <linux/in.h>
 #include <linux/jhash.h>
@@ -1531,12 +1532,10 @@ static inline bool is_skb_forwardable(struct net_device *dev,
  */
 int dev_forward_skb(struct net_device *dev, struct sk_buff *skb)
 {
-	if (skb_shinfo(skb)->tx_flags & SKBTX_DEV_ZEROCOPY) {
-		if (skb_copy_ubufs(skb, GFP_ATOMIC)) {
-			atomic_long_inc(&dev->rx_dropped);
-			kfree_skb(skb);
-			return NET_RX_DROP;
-		}
+	if (skb_orphan_frags_rx(skb, GFP_ATOMIC)) {
+		atomic_long_inc(&dev->rx_dropped);
+		kfree_skb(skb);
+		return NET_RX_DROP;
 	}
 
 	skb_orphan(skb);
@@ -1559,6 +1558,8 @@ static inline int deliver_skb(struct sk_buff *skb,
 			      struct packet_type *pt_prev,
 			      struct net_device *orig_dev)
 {
+	if (unlikely(skb_orphan_frags_rx(skb, GFP_ATOMIC)))
+		return -ENOMEM;
 	atomic_inc(&skb->users);
 	return pt_prev->func(skb, skb->dev, pt_prev, orig_dev);
 }
@@ -1615,8 +1616,12 @@ static void dev_queue_xmit_nit(struct sk_buff *skb, struct net_device *dev)
 			pt_prev = ptype;
 		}
 	}
-	if (pt_prev)
-		pt_prev->func(skb2, skb->dev, pt_prev, skb->dev);
+	if (pt_prev) {
+		if (!skb_orphan_frags_rx(skb2, GFP_ATOMIC))
+			pt_prev->func(skb2, skb->dev, pt_prev, skb->dev);
+		else
+			kfree_skb(skb2);
+	}
 	rcu_read_unlock();
 }
 
@@ -2045,25 +2050,6 @@ static int dev_gso_segment(struct sk_buff *skb, int features)
 	return 0;
 }
 
-/*
- * Try to orphan skb early, right before transmission by the device.
- * We cannot orphan skb if tx timestamp is requested or the sk-reference
- * is needed on driver level for other reasons, e.g. see net/can/raw.c
- */
-static inline void skb_orphan_try(struct sk_buff *skb)
-{
-	struct sock *sk = skb->sk;
-
-	if (sk && !skb_shinfo(skb)->tx_flags) {
-		/* skb_tx_hash() wont be able to get sk.
-		 * We copy sk_hash into skb->rxhash
-		 */
-		if (!skb->rxhash)
-			skb->rxhash = sk->sk_hash;
-		skb_orphan(skb);
-	}
-}
-
 static bool can_checksum_protocol(unsigned long features, __be16 protocol)
 {
 	return ((features & NETIF_F_GEN_CSUM) ||
@@ -2148,8 +2134,6 @@ int dev_hard_start_xmit(struct sk_buff *skb, struct net_device *dev,
 		if (!list_empty(&ptype_all))
 			dev_queue_xmit_nit(skb, dev);
 
-		skb_orphan_try(skb);
-
 		features = netif_skb_features(skb);
 
 		if (vlan_tx_tag_present(skb) &&
@@ -2217,7 +2201,7 @@ gso:
 			return rc;
 		}
 		txq_trans_update(txq);
-		if (unlikely(netif_tx_queue_stopped(txq) && skb->next))
+		if (unlikely(netif_xmit_stopped(txq) && skb->next))
 			return NETDEV_TX_BUSY;
 	} while (skb->next);
 
@@ -2505,7 +2489,7 @@ int dev_queue_xmit(struct sk_buff *skb)
 
 			HARD_TX_LOCK(dev, txq, cpu);
 
-			if (!netif_tx_queue_stopped(txq)) {
+			if (!netif_xmit_stopped(txq)) {
 				__this_cpu_inc(xmit_recursion);
 				rc = dev_hard_start_xmit(skb, dev, txq);
 				__this_cpu_dec(xmit_recursion);
@@ -3251,8 +3235,11 @@ ncls:
 	}
 
 	if (pt_prev) {
+		if (unlikely(skb_orphan_frags_rx(skb, GFP_ATOMIC)))
+			goto drop;
 		ret = pt_prev->func(skb, skb->dev, pt_prev, orig_dev);
 	} else {
+drop:
 		atomic_long_inc(&skb->dev->rx_dropped);
 		kfree_skb(skb);
 		/* Jamal, now you will not able to escape explaining
@@ -3539,6 +3526,7 @@ EXPORT_SYMBOL(skb_gro_reset_offset);
 
 gro_result_t napi_gro_receive(struct napi_struct *napi, struct sk_buff *skb)
 {
+	skb_mark_napi_id(skb, napi);
 	skb_gro_reset_offset(skb);
 
 	return napi_skb_finish(__napi_gro_receive(napi, skb), skb);
@@ -3605,6 +3593,7 @@ struct sk_buff *napi_frags_skb(struct napi_struct *napi)
 
 	napi->skb = NULL;
 
+	skb_mark_napi_id(skb, napi);
 	skb_reset_mac_header(skb);
 	skb_gro_reset_offset(skb);
 
@@ -3774,6 +3763,172 @@ void napi_complete(struct napi_struct *n)
 }
 EXPORT_SYMBOL(napi_complete);
 
+#ifdef CONFIG_NET_RX_BUSY_POLL
+#define NAPI_HASH_BITS	8
+
+/* Every NAPI context gets an id so that sockets can find the one their
+ * packets arrive on without holding a reference to it.
+ */
+static struct hlist_head napi_hash[1 << NAPI_HASH_BITS];
+static DEFINE_SPINLOCK(napi_hash_lock);
+static unsigned int napi_gen_id;
+
+/* must be called under rcu_read_lock(), as we dont take a reference */
+static struct napi_struct *napi_by_id(unsigned int napi_id)
+{
+	unsigned int hash = napi_id % ARRAY_SIZE(napi_hash);
+	struct napi_struct *napi;
+	struct hlist_node *node;
+
+	hlist_for_each_entry_rcu(napi, node, &napi_hash[hash], napi_hash_node)
+		if (napi->napi_id == napi_id)
+			return napi;
+
+	return NULL;
+}
+
+static void napi_hash_add(struct napi_struct *napi)
+{
+	spin_lock(&napi_hash_lock);
+
+	/* 0 is not a valid id, we also skip an id that is taken
+	 * we expect both events to be extremely rare
+	 */
+	do {
+		if (unlikely(++napi_gen_id == 0))
+			napi_gen_id = 1;
+	} while (napi_by_id(napi_gen_id));
+	napi->napi_id = napi_gen_id;
+
+	hlist_add_head_rcu(&napi->napi_hash_node,
+			   &napi_hash[napi->napi_id % ARRAY_SIZE(napi_hash)]);
+
+	spin_unlock(&napi_hash_lock);
+}
+
+/* Warning : caller is responsible to make sure rcu grace period
+ * is respected before freeing memory containing @napi
+ */
+static bool napi_hash_del(struct napi_struct *napi)
+{
+	bool rcu_sync_needed = false;
+
+	spin_lock(&napi_hash_lock);
+
+	if (napi->napi_id) {
+		rcu_sync_needed = true;
+		hlist_del_rcu(&napi->napi_hash_node);
+		napi->napi_id = 0;
+	}
+	spin_unlock(&napi_hash_lock);
+	return rcu_sync_needed;
+}
+
+/* Run one ->poll() of @napi from process context, with BH disabled.
+ *
+ * The poller takes ownership by setting NAPI_STATE_SCHED, exactly as an
+ * interrupt would, so it never races with the softirq for the device.
+ * The instance sits on a private list while polled, which lets drivers
+ * that complete the poll unlink it as they would from the softirq list.
+ */
+static int napi_busy_poll(struct napi_struct *napi)
+{
+	LIST_HEAD(busy_list);
+	void *have;
+	int work;
+
+	/* already scheduled: softirq or another poller delivers the data */
+	if (test_and_set_bit(NAPI_STATE_SCHED, &napi->state))
+		return 0;
+
+	if (unlikely(napi_disable_pending(napi))) {
+		smp_mb__before_clear_bit();
+		clear_bit(NAPI_STATE_SCHED, &napi->state);
+		return 0;
+	}
+
+	have = netpoll_poll_lock(napi);
+
+	list_add(&napi->poll_list, &busy_list);
+	work = napi->poll(napi, BUSY_POLL_BUDGET);
+	trace_napi_poll(napi);
+
+	WARN_ON_ONCE(work > BUSY_POLL_BUDGET);
+
+	/* The driver did not complete: there is more to receive, so hand
+	 * the instance over to the softirq like an interrupt would.
+	 */
+	if (!list_empty(&busy_list)) {
+		if (unlikely(napi_disable_pending(napi)))
+			napi_complete(napi);
+		else {
+			list_del(&napi->poll_list);
+			__napi_schedule(napi);
+		}
+	}
+
+	netpoll_poll_unlock(have);
+	return work;
+}
+
+/**
+ *	sk_busy_loop - busy poll the device queue a socket receives from
+ *	@sk: socket waiting for data
+ *	@nonblock: poll once instead of up to the socket's busy poll budget
+ *
+ *	Polls the NAPI context the last packet of @sk arrived on until data
+ *	is queued to @sk, the budget of sk->sk_ll_usec microseconds runs out
+ *	or the task has something better to do. Returns true if the receive
+ *	queue of @sk is no longer empty.
+ */
+bool sk_busy_loop(struct sock *sk, int nonblock)
+{
+	u64 end_time = busy_loop_us_clock() + ACCESS_ONCE(sk->sk_ll_usec);
+	struct napi_struct *napi;
+	bool rc = false;
+
+	rcu_read_lock();
+
+	napi = napi_by_id(sk->sk_napi_id);
+	if (!napi)
+		goto out;
+
+	do {
+		int work;
+
+		local_bh_disable();
+		work = napi_busy_poll(napi);
+		if (work > 0)
+			NET_ADD_STATS_BH(sock_net(sk),
+					 LINUX_MIB_BUSYPOLLRXPACKETS, work);
+		local_bh_enable();
+
+		if (nonblock || !skb_queue_empty(&sk->sk_receive_queue))
+			break;
+		cpu_relax();
+	} while (!need_resched() && !signal_pending(current) &&
+		 busy_loop_us_clock() < end_time);
+
+	rc = !skb_queue_empty(&sk->sk_receive_queue);
+out:
+	rcu_read_unlock();
+	return rc;
+}
+EXPORT_SYMBOL(sk_busy_loop);
+
+#else /* CONFIG_NET_RX_BUSY_POLL */
+
+static inline void napi_hash_add(struct napi_struct *napi)
+{
+}
+
+static inline bool napi_hash_del(struct napi_struct *napi)
+{
+	return false;
+}
+
+#endif /* CONFIG_NET_RX_BUSY_POLL */
+
 void netif_napi_add(struct net_device *dev, struct napi_struct *napi,
 		    int (*poll)(struct napi_struct *, int), int weight)
 {
@@ -3790,6 +3945,7 @@ void netif_napi_add(struct net_device *dev, struct napi_struct *napi,
 	napi->poll_owner = -1;
 #endif
 	set_bit(NAPI_STATE_SCHED, &napi->state);
+	napi_hash_add(napi);
 }
 EXPORT_SYMBOL(netif_napi_add);
 
@@ -3797,6 +3953,8 @@ void netif_napi_del(struct napi_struct *napi)
 {
 	struct sk_buff *skb, *next;
 
+	if (napi_hash_del(napi))
+		synchronize_net();
 	list_del_init(&napi->dev_list);
 	napi_free_frags(napi);
 
@@ -5435,6 +5593,9 @@ static void netdev_init_one_queue(struct net_device *dev,
 	queue->xmit_lock_owner = -1;
 	netdev_queue_numa_node_write(queue, NUMA_NO_NODE);
 	queue->dev = dev;
+#ifdef CONFIG_BQL
+	dql_init(&queue->dql, HZ);
+#endif
 }
 
 static int netif_alloc_netdev_queues(struct net_device *dev)
@@ -18,6 +18,7 @@
 #include <linux/vmalloc.h>
 
 #include <net/request_sock.h>
+#include <net/tcp.h>
 
 /*
  * Maximum number of SYN_RECV sockets in queue per LISTEN socket.
@@ -129,3 +130,77 @@ void reqsk_queue_destroy(struct request_sock_queue *queue)
 		kfree(lopt);
 }
 
+
+/*
+ * This function is called to set a Fast Open socket's "fastopen_rsk" field
+ * to NULL when a TFO socket no longer needs to access the request_sock.
+ * This happens only after 3WHS has been either completed or aborted (e.g.,
+ * RST is received).
+ *
+ * Before TFO, a child socket is created only after 3WHS is completed,
+ * hence it never needs to access the request_sock. With TFO a child
+ * socket, accepted or not, has to access its request_sock for 3WHS
+ * processing, e.g., to retransmit SYN-ACK pkts, until 3WHS is either
+ * completed or aborted. Afterwards the req will stay until either the
+ * child socket is accepted, or in the rare case when the listener is
+ * closed before the child is accepted.
+ *
+ * In short, a request socket is only freed after BOTH 3WHS has completed
+ * (or aborted) and the child socket has been accepted (or listener closed).
+ * When a child socket is accepted, its corresponding req->sk is set to
+ * NULL since it's no longer needed. "req->sk == NULL" is used below to
+ * determine if a child socket has been accepted or not, and the check is
+ * protected by fastopenq->lock.
+ *
+ * fastopen_rsk is only accessed from the child socket's context with its
+ * socket lock held, but a req can be reached both through fastopen_rsk
+ * and through the listener's icsk_accept_queue. The per listener
+ * fastopenq->lock serializes the two; it also protects fastopenq->qlen,
+ * which is decremented here once fastopen_rsk is no longer needed.
+ *
+ * A TFO req holds a reference on its listener (treq->listener), which is
+ * dropped here as well.
+ */
+void reqsk_fastopen_remove(struct sock *sk, struct request_sock *req,
+			   bool reset)
+{
+	struct sock *lsk = tcp_rsk(req)->listener;
+	struct fastopen_queue *fastopenq =
+	    inet_csk(lsk)->icsk_accept_queue.fastopenq;
+
+	BUG_ON(!spin_is_locked(&sk->sk_lock.slock) && !sock_owned_by_user(sk));
+
+	tcp_sk(sk)->fastopen_rsk = NULL;
+	spin_lock_bh(&fastopenq->lock);
+	fastopenq->qlen--;
+	tcp_rsk(req)->listener = NULL;
+	if (req->sk)	/* the child socket hasn't been accepted yet */
+		goto out;
+
+	if (!reset || lsk->sk_state != TCP_LISTEN) {
+		/* If the listener has been closed don't bother with the
+		 * special RST handling below.
+		 */
+		spin_unlock_bh(&fastopenq->lock);
+		sock_put(lsk);
+		reqsk_free(req);
+		return;
+	}
+	/* Wait for 60secs before removing a req that has triggered RST.
+	 * This is a simple defense against TFO spoofing attack - by
+	 * counting the req against fastopen.max_qlen, and disabling
+	 * TFO when the qlen exceeds max_qlen.
+	 */
+	req->expires = jiffies + 60*HZ;
+	if (fastopenq->rskq_rst_head == NULL)
+		fastopenq->rskq_rst_head = req;
+	else
+		fastopenq->rskq_rst_tail->dl_next = req;
+
+	req->dl_next = NULL;
+	fastopenq->rskq_rst_tail = req;
+	fastopenq->qlen++;
+out:
+	spin_unlock_bh(&fastopenq->lock);
+	sock_put(lsk);
+}
@@ -348,7 +348,7 @@ static void skb_release_data(struct sk_buff *skb)
 
 			uarg = skb_shinfo(skb)->destructor_arg;
 			if (uarg->callback)
-				uarg->callback(uarg);
+				uarg->callback(uarg, true);
 		}
 
 		if (skb_has_frag_list(skb))
@@ -539,6 +539,9 @@ static void __copy_skb_header(struct sk_buff *new, const struct sk_buff *old)
 	new->mac_header		= old->mac_header;
 	skb_dst_copy(new, old);
 	new->rxhash		= old->rxhash;
+#ifdef CONFIG_NET_RX_BUSY_POLL
+	new->napi_id		= old->napi_id;
+#endif
 #ifdef CONFIG_XFRM
 	new->sp			= secpath_get(old->sp);
 #endif
@@ -621,6 +624,232 @@ struct sk_buff *skb_morph(struct sk_buff *dst, struct sk_buff *src)
 }
 EXPORT_SYMBOL_GPL(skb_morph);
 
+/* The completion notification skb for MSG_ZEROCOPY is allocated up front,
+ * together with its ubuf_info, which lives in skb->cb until the skb is
+ * queued on the error queue.
+ */
+static inline struct sk_buff *skb_from_uarg(struct ubuf_info *uarg)
+{
+	return container_of((void *)uarg, struct sk_buff, cb);
+}
+
+struct ubuf_info *sock_zerocopy_alloc(struct sock *sk, size_t size)
+{
+	struct ubuf_info *uarg;
+	struct sk_buff *skb;
+
+	BUILD_BUG_ON(sizeof(*uarg) > sizeof(skb->cb));
+
+	skb = sock_omalloc(sk, 0, GFP_KERNEL);
+	if (!skb)
+		return NULL;
+
+	uarg = (void *)skb->cb;
+	memset(uarg, 0, sizeof(*uarg));
+	uarg->callback = sock_zerocopy_callback;
+	uarg->id = ((u32)atomic_inc_return(&sk->sk_zckey)) - 1;
+	uarg->len = 1;
+	uarg->bytelen = size;
+	uarg->zerocopy = 1;
+	atomic_set(&uarg->refcnt, 1);
+	sock_hold(sk);
+
+	return uarg;
+}
+EXPORT_SYMBOL_GPL(sock_zerocopy_alloc);
+
+/* Extend the notification range of @uarg, the completion still attached
+ * to the tail of the write queue, to cover one more send call. Called
+ * with the socket locked, which serializes uarg->len and sk_zckey.
+ */
+struct ubuf_info *sock_zerocopy_realloc(struct sock *sk, size_t size,
+					struct ubuf_info *uarg)
+{
+	if (uarg && skb_zcopy_is_sock(uarg)) {
+		const u32 byte_limit = 1 << 19;	/* limit to a few TSO */
+		u32 bytelen, next;
+
+		bytelen = uarg->bytelen + size;
+		if (uarg->len == USHRT_MAX - 1 || bytelen > byte_limit)
+			goto new_alloc;
+
+		next = (u32)atomic_read(&sk->sk_zckey);
+		if ((u32)(uarg->id + uarg->len) == next) {
+			uarg->len++;
+			uarg->bytelen = bytelen;
+			atomic_set(&sk->sk_zckey, ++next);
+			sock_zerocopy_get(uarg);
+			return uarg;
+		}
+	}
+
+new_alloc:
+	return sock_zerocopy_alloc(sk, size);
+}
+EXPORT_SYMBOL_GPL(sock_zerocopy_realloc);
+
+static bool skb_zerocopy_notify_extend(struct sk_buff *skb, u32 lo, u16 len,
+				       u8 code)
+{
+	struct sock_exterr_skb *serr = SKB_EXT_ERR(skb);
+	u32 old_lo, old_hi;
+	u64 sum_len;
+
+	if (serr->ee.ee_errno || serr->ee.ee_origin != SO_EE_ORIGIN_ZEROCOPY ||
+	    serr->ee.ee_code != code)
+		return false;
+
+	old_lo = serr->ee.ee_info;
+	old_hi = serr->ee.ee_data;
+	sum_len = old_hi - old_lo + 1ULL + len;
+
+	if (sum_len >= (1ULL << 32))
+		return false;
+
+	if (lo != old_hi + 1)
+		return false;
+
+	serr->ee.ee_data += len;
+	return true;
+}
+
+static void sock_zerocopy_notify(struct ubuf_info *uarg)
+{
+	struct sk_buff *tail, *skb = skb_from_uarg(uarg);
+	struct sock_exterr_skb *serr;
+	struct sock *sk = skb->sk;
+	struct sk_buff_head *q;
+	unsigned long flags;
+	u32 lo, hi;
+	u16 len;
+	u8 code;
+
+	/* if !len, there was only 1 call, and it was aborted
+	 * so do not queue a completion notification
+	 */
+	if (!uarg->len || sock_flag(sk, SOCK_DEAD))
+		goto release;
+
+	len = uarg->len;
+	lo = uarg->id;
+	hi = uarg->id + len - 1;
+	code = uarg->zerocopy ? 0 : SO_EE_CODE_ZEROCOPY_COPIED;
+
+	serr = SKB_EXT_ERR(skb);
+	memset(serr, 0, sizeof(*serr));
+	serr->ee.ee_errno = 0;
+	serr->ee.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+	serr->ee.ee_code = code;
+	serr->ee.ee_info = lo;
+	serr->ee.ee_data = hi;
+
+	q = &sk->sk_error_queue;
+	spin_lock_irqsave(&q->lock, flags);
+	tail = skb_peek_tail(q);
+	if (!tail || !skb_zerocopy_notify_extend(tail, lo, len, code)) {
+		__skb_queue_tail(q, skb);
+		skb = NULL;
+	}
+	spin_unlock_irqrestore(&q->lock, flags);
+
+	sk->sk_error_report(sk);
+
+release:
+	consume_skb(skb);
+	sock_put(sk);
+}
+
+/* Called once for every skb that held @uarg, with @success false if its
+ * frags had to be copied after all.
+ */
+void sock_zerocopy_callback(struct ubuf_info *uarg, bool success)
+{
+	if (!success)
+		uarg->zerocopy = 0;
+	sock_zerocopy_put(uarg);
+}
+EXPORT_SYMBOL_GPL(sock_zerocopy_callback);
+
+void sock_zerocopy_put(struct ubuf_info *uarg)
+{
+	if (uarg && atomic_dec_and_test(&uarg->refcnt))
+		sock_zerocopy_notify(uarg);
+}
+EXPORT_SYMBOL_GPL(sock_zerocopy_put);
+
+/* Drop the sender's reference after a send call that failed before any
+ * data was queued, giving its notification id back.
+ */
+void sock_zerocopy_put_abort(struct ubuf_info *uarg)
+{
+	if (uarg) {
+		struct sock *sk = skb_from_uarg(uarg)->sk;
+
+		atomic_dec(&sk->sk_zckey);
+		uarg->len--;
+
+		sock_zerocopy_put(uarg);
+	}
+}
+EXPORT_SYMBOL_GPL(sock_zerocopy_put_abort);
+
+/**
+ *	skb_zerocopy_from_user - pin user pages as frags of a stream skb
+ *	@sk: socket the skb is queued on
+ *	@skb: skb to append to
+ *	@from: user buffer
+ *	@len: number of bytes to append
+ *	@uarg: completion to attach to @skb
+ *
+ *	Appends up to @len bytes of @from to @skb by reference, without
+ *	copying, and charges them to @sk like copied data. Returns the number
+ *	of bytes appended, -EEXIST if @skb already carries a different
+ *	completion, -EMSGSIZE if it has no free frag slot left, or -EFAULT.
+ */
+int skb_zerocopy_from_user(struct sock *sk, struct sk_buff *skb,
+			   const unsigned char __user *from, int len,
+			   struct ubuf_info *uarg)
+{
+	struct ubuf_info *orig_uarg = skb_zcopy(skb);
+	int i = skb_shinfo(skb)->nr_frags;
+	int copied = 0;
+
+	if (orig_uarg && uarg != orig_uarg)
+		return -EEXIST;
+
+	while (copied < len && i < MAX_SKB_FRAGS) {
+		unsigned long addr = (unsigned long)from + copied;
+		int off = addr & ~PAGE_MASK;
+		int size = min_t(int, len - copied, PAGE_SIZE - off);
+		struct page *page;
+
+		if (get_user_pages_fast(addr, 1, 0, &page) != 1)
+			break;
+
+		if (skb_can_coalesce(skb, i, page, off)) {
+			put_page(page);
+			skb_shinfo(skb)->frags[i - 1].size += size;
+		} else {
+			skb_fill_page_desc(skb, i, page, off, size);
+			i++;
+		}
+		copied += size;
+	}
+
+	if (!copied)
+		return i == MAX_SKB_FRAGS ? -EMSGSIZE : -EFAULT;
+
+	skb->len	     += copied;
+	skb->data_len	     += copied;
+	skb->truesize	     += copied;
+	sk->sk_wmem_queued   += copied;
+	sk_mem_charge(sk, copied);
+
+	skb_zcopy_set(skb, uarg);
+	return copied;
+}
+EXPORT_SYMBOL_GPL(skb_zerocopy_from_user);
+
 /*	skb_copy_ubufs	-	copy userspace skb frags buffers to kernel
  *	@skb: the skb to modify
  *	@gfp_mask: allocation priority
@@ -633,7 +862,7 @@ EXPORT_SYMBOL_GPL(skb_morph);
  *	%GFP_ATOMIC.
  *
  *	Returns 0 on success or a negative error code on failure
- *	to allocate kernel memory to copy to.
+ *	to allocate kernel memory to copy to, or if the skb is shared.
  */
 int skb_copy_ubufs(struct sk_buff *skb, gfp_t gfp_mask)
 {
@@ -642,6 +871,10 @@ int skb_copy_ubufs(struct sk_buff *skb, gfp_t gfp_mask)
 	struct page *page, *head = NULL;
 	struct ubuf_info *uarg = skb_shinfo(skb)->destructor_arg;
 
+	/* The frags are rewritten in place; other users must not see that */
+	if (skb_shared(skb) || skb_unclone(skb, gfp_mask))
+		return -EINVAL;
+
 	for (i = 0; i < num_frags; i++) {
 		u8 *vaddr;
 		skb_frag_t *f = &skb_shinfo(skb)->frags[i];
@@ -667,7 +900,7 @@ int skb_copy_ubufs(struct sk_buff *skb, gfp_t gfp_mask)
 	for (i = 0; i < skb_shinfo(skb)->nr_frags; i++)
 		put_page(skb_shinfo(skb)->frags[i].page);
 
-	uarg->callback(uarg);
+	uarg->callback(uarg, false);
 
 	/* skb frags point to kernel buffers */
 	for (i = skb_shinfo(skb)->nr_frags; i > 0; i--) {
@@ -699,10 +932,8 @@ struct sk_buff *skb_clone(struct sk_buff *skb, gfp_t gfp_mask)
 {
 	struct sk_buff *n;
 
-	if (skb_shinfo(skb)->tx_flags & SKBTX_DEV_ZEROCOPY) {
-		if (skb_copy_ubufs(skb, gfp_mask))
-			return NULL;
-	}
+	if (skb_orphan_frags(skb, gfp_mask))
+		return NULL;
 
 	n = skb + 1;
 	if (skb->fclone == SKB_FCLONE_ORIG &&
@@ -821,18 +1052,17 @@ struct sk_buff *pskb_copy(struct sk_buff *skb, gfp_t gfp_mask)
 	if (skb_shinfo(skb)->nr_frags) {
 		int i;
 
-		if (skb_shinfo(skb)->tx_flags & SKBTX_DEV_ZEROCOPY) {
-			if (skb_copy_ubufs(skb, gfp_mask)) {
-				kfree_skb(n);
-				n = NULL;
-				goto out;
-			}
+		if (skb_orphan_frags(skb, gfp_mask)) {
+			kfree_skb(n);
+			n = NULL;
+			goto out;
 		}
 		for (i = 0; i < skb_shinfo(skb)->nr_frags; i++) {
 			skb_shinfo(n)->frags[i] = skb_shinfo(skb)->frags[i];
 			skb_frag_ref(skb, i);
 		}
 		skb_shinfo(n)->nr_frags = i;
+		skb_zerocopy_clone(n, skb);
 	}
 
 	if (skb_has_frag_list(skb)) {
@@ -916,10 +1146,11 @@ int pskb_expand_head(struct sk_buff *skb, int nhead, int ntail,
 		kfree(skb->head);
 	} else {
 		/* copy this zero copy skb frags */
-		if (skb_shinfo(skb)->tx_flags & SKBTX_DEV_ZEROCOPY) {
-			if (skb_copy_ubufs(skb, gfp_mask))
-				goto nofrags;
-		}
+		if (skb_orphan_frags(skb, gfp_mask))
+			goto nofrags;
+		/* the new head inherits the zerocopy completion as well */
+		if (skb_zcopy(skb))
+			sock_zerocopy_get(skb_zcopy(skb));
 		for (i = 0; i < skb_shinfo(skb)->nr_frags; i++)
 			skb_frag_ref(skb, i);
 
@@ -2199,6 +2430,7 @@ void skb_split(struct sk_buff *skb, struct sk_buff *skb1, const u32 len)
 {
 	int pos = skb_headlen(skb);
 
+	skb_zerocopy_clone(skb1, skb);
 	if (len < pos)	/* Split line is inside header. */
 		skb_split_inside_header(skb, skb1, len, pos);
 	else		/* Second chunk has no header, nothing to copy. */
@@ -2241,6 +2473,10 @@ int skb_shift(struct sk_buff *tgt, struct sk_buff *skb, int shiftlen)
 	BUG_ON(shiftlen > skb->len);
 	BUG_ON(skb_headlen(skb));	/* Would corrupt stream */
 
+	/* Frags of different zerocopy completions cannot be mixed */
+	if (skb_zcopy(tgt) || skb_zcopy(skb))
+		return 0;
+
 	todo = shiftlen;
 	from = 0;
 	to = skb_shinfo(tgt)->nr_frags;
@@ -2711,6 +2947,7 @@ struct sk_buff *skb_segment(struct sk_buff *skb, u32 features)
 		}
 
 		frag = skb_shinfo(nskb)->frags;
+		skb_zerocopy_clone(nskb, skb);
 
 		skb_copy_from_linear_data_offset(skb, offset,
 						 skb_put(nskb, hsize), hsize);
@@ -115,8 +115,6 @@
 #define RT_FL_TOS(oldflp4) \
 	((oldflp4)->flowi4_tos & (IPTOS_RT_MASK | RTO_ONLINK))
 
-#define IP_MAX_MTU	0xFFF0
-
 #define RT_GC_TIMEOUT (300*HZ)
 
 static int ip_rt_max_size;
@@ -133,10 +131,12 @@ static int ip_rt_mtu_expires __read_mostly	= 10 * 60 * HZ;
 static int ip_rt_min_pmtu __read_mostly		= 512 + 20 + 20;
 static int ip_rt_min_advmss __read_mostly	= 256;
 static int rt_chain_length_max __read_mostly	= 20;
+static int ip_rt_no_cache __read_mostly;
 static int redirect_genid;
 
 static struct delayed_work expires_work;
 static unsigned long expires_ljiffies;
+static struct work_struct rt_flush_work;
 
 /*
  *	Interface to generic destination cache.
@@ -722,7 +722,8 @@ static inline u32 rt_score(struct rtable *rt)
 
 static inline bool rt_caching(const struct net *net)
 {
-	return net->ipv4.current_rt_cache_rebuild_count <=
+	return !ip_rt_no_cache &&
+		net->ipv4.current_rt_cache_rebuild_count <=
 		net->ipv4.sysctl_rt_cache_rebuild_count;
 }
 
@@ -756,7 +757,9 @@ static inline int rt_is_expired(struct rtable *rth)
 }
 
 /*
- * Perform a full scan of hash table and free all entries.
+ * Perform a full scan of hash table and free all entries of @net.
+ * Without @net, free only the entries a genid bump invalidated, or all
+ * of them if the cache is disabled.
  * Can be called by a softirq or a process.
  * In the later case, we want to be reschedule if necessary
  */
@@ -786,8 +789,8 @@ static void rt_do_flush(struct net *net, int process_context)
 			next = rcu_dereference_protected(rth->dst.rt_next,
 				lockdep_is_held(rt_hash_lock_addr(i)));
 
-			if (!net ||
-			    net_eq(dev_net(rth->dst.dev), net)) {
+			if (net ? net_eq(dev_net(rth->dst.dev), net) :
+				  ip_rt_no_cache || rt_is_expired(rth)) {
 				rcu_assign_pointer(*pprev, next);
 				rcu_assign_pointer(rth->dst.rt_next, list);
 				list = rth;
@@ -942,15 +945,28 @@ static void rt_cache_invalidate(struct net *net)
 	redirect_genid++;
 }
 
+/*
+ * Invalidated entries are never returned by a lookup, so the table
+ * walk that frees them does not have to hold up whoever changed the
+ * interface or the FIB. Hand it to a worker, so that a burst of link
+ * and address events costs a single walk, done in process context.
+ * The worker frees only stale entries: a namespace that asked for a
+ * flush has bumped its genid, the others keep their routes.
+ */
+static void rt_flush_worker(struct work_struct *work)
+{
+	rt_do_flush(NULL, 1);
+}
+
 /*
  * delay < 0  : invalidate cache (fast : entries will be deleted later)
- * delay >= 0 : invalidate & flush cache (can be long)
+ * delay >= 0 : invalidate cache & schedule a flush of the stale entries
  */
 void rt_cache_flush(struct net *net, int delay)
 {
 	rt_cache_invalidate(net);
 	if (delay >= 0)
-		rt_do_flush(net, !in_softirq());
+		schedule_work(&rt_flush_work);
 }
 
 /* Flush previous cache invalidated entries from the cache */
@@ -991,6 +1007,14 @@ static int rt_garbage_collect(struct dst_ops *ops)
 	int goal;
 	int entries = dst_entries_get_fast(&ipv4_dst_ops);
 
+	/*
+	 * Without the cache every route belongs to whoever looked it up
+	 * and goes away with its last reference: there is nothing to
+	 * scan for, only the overall limit to enforce.
+	 */
+	if (ip_rt_no_cache)
+		return dst_entries_get_slow(&ipv4_dst_ops) >= ip_rt_max_size;
+
 	/*
 	 * Garbage collection is pretty expensive,
 	 * do not make it too frequently.
@@ -3243,6 +3267,18 @@ static int ipv4_sysctl_rtcache_flush(ctl_table *__ctl, int write,
 	return -EINVAL;
 }
 
+static int ipv4_sysctl_rt_no_cache(ctl_table *ctl, int write,
+				   void __user *buffer,
+				   size_t *lenp, loff_t *ppos)
+{
+	int ret = proc_dointvec(ctl, write, buffer, lenp, ppos);
+
+	/* lookups stop looking at the table, drop what it still holds */
+	if (write && !ret && ip_rt_no_cache)
+		schedule_work(&rt_flush_work);
+	return ret;
+}
+
 static ctl_table ipv4_route_table[] = {
 	{
 		.procname	= "gc_thresh",
@@ -3337,6 +3373,13 @@ static ctl_table ipv4_route_table[] = {
 		.mode		= 0644,
 		.proc_handler	= proc_dointvec,
 	},
+	{
+		.procname	= "no_cache",
+		.data		= &ip_rt_no_cache,
+		.maxlen		= sizeof(int),
+		.mode		= 0644,
+		.proc_handler	= ipv4_sysctl_rt_no_cache,
+	},
 	{
 		.procname	= "mtu_expires",
 		.data		= &ip_rt_mtu_expires,
@@ -3505,6 +3548,7 @@ int __init ip_rt_init(void)
 	devinet_init();
 	ip_fib_init();
 
+	INIT_WORK(&rt_flush_work, rt_flush_worker);
 	INIT_DELAYED_WORK_DEFERRABLE(&expires_work, rt_worker_func);
 	expires_ljiffies = jiffies;
 	schedule_delayed_work(&expires_work,
@@ -105,6 +105,7 @@
 #include <net/route.h>
 #include <net/checksum.h>
 #include <net/xfrm.h>
+#include <net/busy_poll.h>
 #include <trace/events/udp.h>
 #include "udp_impl.h"
 
@@ -123,6 +124,9 @@ EXPORT_SYMBOL(sysctl_udp_wmem_min);
 atomic_long_t udp_memory_allocated;
 EXPORT_SYMBOL(udp_memory_allocated);
 
+/* Set once a socket enables UDP_GRO; until then GRO skips the lookup. */
+static int udp_gro_needed __read_mostly;
+
 #define MAX_UDP_PORTS 65536
 #define PORTS_PER_CHAIN (MAX_UDP_PORTS / UDP_HTABLE_SIZE_MIN)
 
@@ -707,7 +711,8 @@ static void udp4_hwcsum(struct sk_buff *skb, __be32 src, __be32 dst)
 	}
 }
 
-static int udp_send_skb(struct sk_buff *skb, struct flowi4 *fl4)
+static int udp_send_skb(struct sk_buff *skb, struct flowi4 *fl4,
+			unsigned int gso_size)
 {
 	struct sock *sk = skb->sk;
 	struct inet_sock *inet = inet_sk(sk);
@@ -727,6 +732,43 @@ static int udp_send_skb(struct sk_buff *skb, struct flowi4 *fl4)
 	uh->len = htons(len);
 	uh->check = 0;
 
+	if (gso_size) {				 /* UDP segmentation  */
+		const int hlen = skb_network_header_len(skb) +
+				 sizeof(struct udphdr);
+
+		err = -EINVAL;
+		if (hlen + gso_size > dst_mtu(skb_dst(skb)) ||
+		    len - sizeof(struct udphdr) > gso_size * UDP_MAX_SEGMENTS ||
+		    sk->sk_no_check == UDP_CSUM_NOXMIT)
+			goto drop;
+		err = -EIO;
+		if (is_udplite || dst_xfrm(skb_dst(skb)))
+			goto drop;
+
+		/* A payload that fits in one segment is sent as a plain
+		 * datagram; udp4_gso_segment() would refuse it.
+		 */
+		if (len - sizeof(struct udphdr) > gso_size) {
+			/* The datagram is only split after routing, so leave
+			 * the checksum to the device or to the software GSO
+			 * path. It is recomputed per segment in
+			 * udp4_gso_segment().
+			 */
+			skb->ip_summed = CHECKSUM_PARTIAL;
+			skb->csum_start = skb_transport_header(skb) - skb->head;
+			skb->csum_offset = offsetof(struct udphdr, check);
+			uh->check = ~csum_tcpudp_magic(fl4->saddr, fl4->daddr,
+						       len, IPPROTO_UDP, 0);
+
+			skb_shinfo(skb)->gso_size = gso_size;
+			skb_shinfo(skb)->gso_type = SKB_GSO_UDP_L4;
+			skb_shinfo(skb)->gso_segs =
+				DIV_ROUND_UP(len - sizeof(struct udphdr),
+					     gso_size);
+			goto send;
+		}
+	}
+
 	if (is_udplite)  				 /*     UDP-Lite      */
 		csum = udplite_csum(skb);
 
@@ -761,6 +803,10 @@ send:
 		UDP_INC_STATS_USER(sock_net(sk),
 				   UDP_MIB_OUTDATAGRAMS, is_udplite);
 	return err;
+
+drop:
+	kfree_skb(skb);
+	return err;
 }
 
 /*
@@ -778,7 +824,7 @@ static int udp_push_pending_frames(struct sock *sk)
 	if (!skb)
 		goto out;
 
-	err = udp_send_skb(skb, fl4);
+	err = udp_send_skb(skb, fl4, inet->cork.base.gso_size);
 
 out:
 	up->len = 0;
@@ -786,6 +832,29 @@ out:
 	return err;
 }
 
+static int udp_cmsg_send(struct sock *sk, struct msghdr *msg, u16 *gso_size)
+{
+	struct cmsghdr *cmsg;
+
+	for (cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+		if (!CMSG_OK(msg, cmsg))
+			return -EINVAL;
+		if (cmsg->cmsg_level != SOL_UDP)
+			continue;
+
+		switch (cmsg->cmsg_type) {
+		case UDP_SEGMENT:
+			if (cmsg->cmsg_len != CMSG_LEN(sizeof(__u16)))
+				return -EINVAL;
+			*gso_size = *(__u16 *)CMSG_DATA(cmsg);
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+	return 0;
+}
+
 int udp_sendmsg(struct kiocb *iocb, struct sock *sk, struct msghdr *msg,
 		size_t len)
 {
@@ -819,6 +888,7 @@ int udp_sendmsg(struct kiocb *iocb, struct sock *sk, struct msghdr *msg,
 
 	ipc.opt = NULL;
 	ipc.tx_flags = 0;
+	ipc.gso_size = up->gso_size;
 
 	getfrag = is_udplite ? udplite_getfrag : ip_generic_getfrag;
 
@@ -873,6 +943,9 @@ int udp_sendmsg(struct kiocb *iocb, struct sock *sk, struct msghdr *msg,
 	if (err)
 		return err;
 	if (msg->msg_controllen) {
+		err = udp_cmsg_send(sk, msg, &ipc.gso_size);
+		if (err)
+			return err;
 		err = ip_cmsg_send(sock_net(sk), msg, &ipc);
 		if (err)
 			return err;
@@ -965,7 +1038,7 @@ back_from_confirm:
 				  msg->msg_flags);
 		err = PTR_ERR(skb);
 		if (skb && !IS_ERR(skb))
-			err = udp_send_skb(skb, fl4);
+			err = udp_send_skb(skb, fl4, ipc.gso_size);
 		goto out;
 	}
 
@@ -1234,6 +1307,8 @@ try_again:
 	}
 	if (inet->cmsg_flags)
 		ip_cmsg_recv(msg, skb);
+	if (udp_sk(sk)->gro_enabled)
+		udp_cmsg_recv(msg, sk, skb);
 
 	err = len;
 	if (flags & MSG_TRUNC)
@@ -1356,6 +1431,7 @@ static int __udp_queue_rcv_skb(struct sock *sk, struct sk_buff *skb)
 
 	if (inet_sk(sk)->inet_daddr)
 		sock_rps_save_rxhash(sk, skb->rxhash);
+	sk_mark_napi_id(sk, skb);
 
 	rc = ip_queue_rcv_skb(sk, skb);
 	if (rc < 0) {
@@ -1383,7 +1459,7 @@ static int __udp_queue_rcv_skb(struct sock *sk, struct sk_buff *skb)
  * Note that in the success and error cases, the skb is assumed to
  * have either been requeued or freed.
  */
-int udp_queue_rcv_skb(struct sock *sk, struct sk_buff *skb)
+static int udp_queue_rcv_one_skb(struct sock *sk, struct sk_buff *skb)
 {
 	struct udp_sock *up = udp_sk(sk);
 	int rc;
@@ -1490,6 +1566,50 @@ drop:
 	return -1;
 }
 
+static inline int udp_unexpected_gso(struct sock *sk, struct sk_buff *skb)
+{
+	struct udp_sock *up = udp_sk(sk);
+
+	return (!up->gro_enabled || up->encap_type) && skb_is_gso(skb) &&
+	       (skb_shinfo(skb)->gso_type & SKB_GSO_UDP_L4);
+}
+
+int udp_queue_rcv_skb(struct sock *sk, struct sk_buff *skb)
+{
+	struct sk_buff *segs, *next;
+	int segs_nr;
+
+	if (likely(!udp_unexpected_gso(sk, skb)))
+		return udp_queue_rcv_one_skb(sk, skb);
+
+	/*
+	 * A GRO packet built for a UDP_GRO socket ended up on one that
+	 * wants plain datagrams: split it back, starting from the
+	 * network header as the GSO layer expects.
+	 */
+	segs_nr = skb_shinfo(skb)->gso_segs;
+	__skb_push(skb, skb->data - skb_network_header(skb));
+	segs = skb_gso_segment(skb, NETIF_F_SG | NETIF_F_IP_CSUM);
+	if (unlikely(IS_ERR_OR_NULL(segs))) {
+		atomic_add(segs_nr, &sk->sk_drops);
+		UDP_INC_STATS_BH(sock_net(sk), UDP_MIB_INERRORS,
+				 IS_UDPLITE(sk));
+		kfree_skb(skb);
+		return -1;
+	}
+	consume_skb(skb);
+
+	for (skb = segs; skb; skb = next) {
+		next = skb->next;
+		skb->next = NULL;
+		__skb_pull(skb, skb_transport_offset(skb));
+		/* encap resubmission is not possible for a segment */
+		if (udp_queue_rcv_one_skb(sk, skb) > 0)
+			kfree_skb(skb);
+	}
+	return 0;
+}
+
 
 static void flush_stack(struct sock **stack, unsigned int count,
 			struct sk_buff *skb, unsigned int final)
@@ -1769,6 +1889,18 @@ int udp_lib_setsockopt(struct sock *sk, int level, int optname,
 		}
 		break;
 
+	case UDP_SEGMENT:
+		if (val < 0 || val > USHRT_MAX)
+			return -EINVAL;
+		up->gso_size = val;
+		break;
+
+	case UDP_GRO:
+		if (val)
+			udp_gro_needed = 1;
+		up->gro_enabled = val ? 1 : 0;
+		break;
+
 	/*
 	 * 	UDP-Lite's partial checksum coverage (RFC 3828).
 	 */
@@ -1851,6 +1983,14 @@ int udp_lib_getsockopt(struct sock *sk, int level, int optname,
 		val = up->encap_type;
 		break;
 
+	case UDP_SEGMENT:
+		val = up->gso_size;
+		break;
+
+	case UDP_GRO:
+		val = up->gro_enabled;
+		break;
+
 	/* The following two cannot be changed on UDP sockets, the return is
 	 * always 0 (which corresponds to the full checksum coverage of UDP). */
 	case UDPLITE_SEND_CSCOV:
@@ -2243,6 +2383,66 @@ int udp4_ufo_send_check(struct sk_buff *skb)
 	return 0;
 }
 
+/*
+ * Split a UDP_SEGMENT datagram into gso_size sized datagrams, each with
+ * its own UDP header; the IP headers are fixed up by inet_gso_segment().
+ */
+static struct sk_buff *udp4_gso_segment(struct sk_buff *skb, u32 features)
+{
+	struct sk_buff *segs = ERR_PTR(-EINVAL);
+	const struct iphdr *iph;
+	struct udphdr *uh;
+	unsigned int mss;
+	unsigned int len;
+
+	if (!pskb_may_pull(skb, sizeof(*uh)))
+		goto out;
+
+	mss = skb_shinfo(skb)->gso_size;
+	if (unlikely(skb->len <= sizeof(*uh) + mss))
+		goto out;
+
+	if (skb_gso_ok(skb, features | NETIF_F_GSO_ROBUST)) {
+		/* Packet is from an untrusted source, reset gso_segs. */
+		int type = skb_shinfo(skb)->gso_type;
+
+		if (unlikely(type & ~(SKB_GSO_UDP_L4 | SKB_GSO_DODGY)))
+			goto out;
+
+		skb_shinfo(skb)->gso_segs = DIV_ROUND_UP(skb->len -
+							 sizeof(*uh), mss);
+
+		segs = NULL;
+		goto out;
+	}
+
+	__skb_pull(skb, sizeof(*uh));
+
+	segs = skb_segment(skb, features);
+	if (IS_ERR(segs))
+		goto out;
+
+	skb = segs;
+	do {
+		iph = ip_hdr(skb);
+		uh = udp_hdr(skb);
+		len = skb->len - skb_transport_offset(skb);
+
+		uh->len = htons(len);
+		uh->check = ~csum_tcpudp_magic(iph->saddr, iph->daddr, len,
+					       IPPROTO_UDP, 0);
+		if (skb->ip_summed != CHECKSUM_PARTIAL) {
+			uh->check = csum_fold(csum_partial(uh, sizeof(*uh),
+							   skb->csum));
+			if (uh->check == 0)
+				uh->check = CSUM_MANGLED_0;
+		}
+	} while ((skb = skb->next));
+
+out:
+	return segs;
+}
+
 struct sk_buff *udp4_ufo_fragment(struct sk_buff *skb, u32 features)
 {
 	struct sk_buff *segs = ERR_PTR(-EINVAL);
@@ -2250,6 +2450,9 @@ struct sk_buff *udp4_ufo_fragment(struct sk_buff *skb, u32 features)
 	int offset;
 	__wsum csum;
 
+	if (skb_shinfo(skb)->gso_type & SKB_GSO_UDP_L4)
+		return udp4_gso_segment(skb, features);
+
 	mss = skb_shinfo(skb)->gso_size;
 	if (unlikely(skb->len <= mss))
 		goto out;
@@ -2285,3 +2488,123 @@ out:
 	return segs;
 }
 
+/*
+ * Coalesce datagrams of one flow into a GSO packet for a UDP_GRO socket.
+ * All segments but the last carry gso_size bytes of payload, which is
+ * what dev_gro_receive() records from the first one.
+ */
+static struct sk_buff **udp_gro_receive_segment(struct sk_buff **head,
+						struct sk_buff *skb,
+						struct udphdr *uh)
+{
+	struct sk_buff **pp = NULL;
+	struct sk_buff *p;
+	struct udphdr *uh2;
+	unsigned int ulen = ntohs(uh->len);
+	unsigned int ulen2;
+
+	skb_gro_pull(skb, sizeof(struct udphdr));
+
+	for (; (p = *head); head = &p->next) {
+		if (!NAPI_GRO_CB(p)->same_flow)
+			continue;
+
+		uh2 = udp_hdr(p);
+
+		/* Match ports only, as csum is always non zero */
+		if (*(u32 *)&uh->source ^ *(u32 *)&uh2->source) {
+			NAPI_GRO_CB(p)->same_flow = 0;
+			continue;
+		}
+
+		/* A longer datagram terminates the flow, the first shorter
+		 * one is merged and terminates it too.
+		 */
+		ulen2 = ntohs(uh2->len);
+		if (ulen > ulen2 || NAPI_GRO_CB(p)->flush ||
+		    skb_gro_receive(head, skb))
+			pp = head;
+		else if (ulen != ulen2 ||
+			 NAPI_GRO_CB(*head)->count >= UDP_MAX_SEGMENTS)
+			pp = head;
+
+		return pp;
+	}
+
+	/* mismatch, but we never need to flush */
+	return NULL;
+}
+
+struct sk_buff **udp4_gro_receive(struct sk_buff **head, struct sk_buff *skb)
+{
+	const struct iphdr *iph = skb_gro_network_header(skb);
+	struct udphdr *uh;
+	struct sock *sk;
+	unsigned int hlen;
+	unsigned int off;
+	int gro_enabled;
+
+	if (!udp_gro_needed)
+		goto flush;
+
+	off = skb_gro_offset(skb);
+	hlen = off + sizeof(*uh);
+	uh = skb_gro_header_fast(skb, off);
+	if (skb_gro_header_hard(skb, hlen)) {
+		uh = skb_gro_header_slow(skb, hlen, off);
+		if (unlikely(!uh))
+			goto flush;
+	}
+
+	/* requires non zero csum, for symmetry with GSO */
+	if (!uh->check || ntohs(uh->len) != skb_gro_len(skb))
+		goto flush;
+
+	switch (skb->ip_summed) {
+	case CHECKSUM_COMPLETE:
+		if (!csum_tcpudp_magic(iph->saddr, iph->daddr,
+				       skb_gro_len(skb), IPPROTO_UDP,
+				       skb->csum)) {
+			skb->ip_summed = CHECKSUM_UNNECESSARY;
+			break;
+		}
+
+		/* fall through */
+	case CHECKSUM_NONE:
+		goto flush;
+	}
+
+	sk = __udp4_lib_lookup(dev_net(skb->dev), iph->saddr, uh->source,
+			       iph->daddr, uh->dest, skb->dev->ifindex,
+			       &udp_table);
+	if (!sk)
+		goto flush;
+	gro_enabled = udp_sk(sk)->gro_enabled && !udp_sk(sk)->encap_type;
+	sock_put(sk);
+	if (!gro_enabled)
+		goto flush;
+
+	return udp_gro_receive_segment(head, skb, uh);
+
+flush:
+	NAPI_GRO_CB(skb)->flush = 1;
+	return NULL;
+}
+
+int udp4_gro_complete(struct sk_buff *skb)
+{
+	const struct iphdr *iph = ip_hdr(skb);
+	struct udphdr *uh = udp_hdr(skb);
+	unsigned int len = skb->len - skb_transport_offset(skb);
+
+	uh->len = htons(len);
+	uh->check = ~csum_tcpudp_magic(iph->saddr, iph->daddr, len,
+				       IPPROTO_UDP, 0);
+	skb->csum_start = skb_transport_header(skb) - skb->head;
+	skb->csum_offset = offsetof(struct udphdr, check);
+	skb->ip_summed = CHECKSUM_PARTIAL;
+
+	skb_shinfo(skb)->gso_type = SKB_GSO_UDP_L4;
+	skb_shinfo(skb)->gso_segs = NAPI_GRO_CB(skb)->count;
+	return 0;
+}
@@ -45,6 +45,7 @@
 #include <net/tcp_states.h>
 #include <net/ip6_checksum.h>
 #include <net/xfrm.h>
+#include <net/busy_poll.h>
 
 #include <linux/proc_fs.h>
 #include <linux/seq_file.h>
@@ -426,6 +427,8 @@ try_again:
 	if (is_udp4) {
 		if (inet->cmsg_flags)
 			ip_cmsg_recv(msg, skb);
+		if (udp_sk(sk)->gro_enabled)
+			udp_cmsg_recv(msg, sk, skb);
 	} else {
 		if (np->rxopt.all)
 			datagram_recv_ctl(sk, msg, skb);
@@ -507,6 +510,7 @@ int udpv6_queue_rcv_skb(struct sock * sk, struct sk_buff *skb)
 
 	if (!ipv6_addr_any(&inet6_sk(sk)->daddr))
 		sock_rps_save_rxhash(sk, skb->rxhash);
+	sk_mark_napi_id(sk, skb);
 
 	if (!xfrm6_policy_check(sk, XFRM_POLICY_IN, skb))
 		goto drop;
@@ -1009,6 +1013,10 @@ do_udp_sendmsg:
 	if (up->pending == AF_INET)
 		return udp_sendmsg(iocb, sk, msg, len);
 
+	/* UDP_SEGMENT is only implemented for IPv4 */
+	if (up->gso_size)
+		return -EOPNOTSUPP;
+
 	/* Rough check on arithmetic overflow,
 	   better check is made in ip6_append_data().
 	   */
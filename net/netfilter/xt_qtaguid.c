@@ -15,11 +15,13 @@
 #define DEBUG
 
 #include <linux/file.h>
+#include <linux/hash.h>
 #include <linux/inetdevice.h>
 #include <linux/module.h>
 #include <linux/netfilter/x_tables.h>
 #include <linux/netfilter/xt_qtaguid.h>
 #include <linux/ratelimit.h>
+#include <linux/rculist.h>
 #include <linux/skbuff.h>
 #include <linux/workqueue.h>
 #include <net/addrconf.h>
@@ -129,6 +131,16 @@ static struct proc_dir_entry *iface_stat_fmt_procfile;
  * Notice how sock_tag_list_lock is held sometimes when uid_tag_data_tree_lock
  * is acquired.
  *
+ * The packet path (qtaguid_mt()) takes none of these when the stats entry
+ * already exists. It relies on RCU instead:
+ *  - iface_stat_list is an RCU list, and its entries are never freed.
+ *  - sk->sk_qtag caches the sock_tag, set and cleared under
+ *    sock_tag_list_lock, freed with kfree_rcu().
+ *  - tag_stat and tag_counter_set entries are also linked in RCU hashes,
+ *    updated under their respective locks, freed with kfree_rcu().
+ *  - Counters are per CPU (struct pcpu_data_counters), and only summed by
+ *    the proc readers.
+ *
  * Call tree with all lock holders as of 2012-04-27:
  *
  * iface_stat_fmt_proc_read()
@@ -183,15 +195,9 @@ static struct proc_dir_entry *iface_stat_fmt_procfile;
  * qtaguid_mt()
  *   account_for_uid()
  *     if_tag_stat_update()
- *       get_sock_stat()
- *         sock_tag_list_lock
+ *       (only when the tag_stat needs creating)
  *       struct iface_stat->tag_stat_list_lock
  *         tag_stat_update()
- *           get_active_counter_set()
- *             tag_counter_set_list_lock
- *         tag_stat_update()
- *           get_active_counter_set()
- *             tag_counter_set_list_lock
  *
  *
  * qtaguid_ctrl_parse()
@@ -223,6 +229,7 @@ static struct rb_root sock_tag_tree = RB_ROOT;
 static DEFINE_SPINLOCK(sock_tag_list_lock);
 
 static struct rb_root tag_counter_set_tree = RB_ROOT;
+static struct hlist_head tag_counter_set_hash[1 << TAG_COUNTER_SET_HASH_BITS];
 static DEFINE_SPINLOCK(tag_counter_set_list_lock);
 
 static struct rb_root uid_tag_data_tree = RB_ROOT;
@@ -265,6 +272,11 @@ static inline void dc_add_byte_packets(struct data_counters *counters, int set,
 	counters->bpc[set][direction][ifs_proto].packets += packets;
 }
 
+static struct pcpu_data_counters *pcpu_data_counters_alloc(gfp_t flags)
+{
+	return kcalloc(nr_cpu_ids, sizeof(struct pcpu_data_counters), flags);
+}
+
 static struct tag_node *tag_node_tree_search(struct rb_root *root, tag_t tag)
 {
 	struct rb_node *node = root->rb_node;
@@ -328,10 +340,63 @@ static struct tag_stat *tag_stat_tree_search(struct rb_root *root, tag_t tag)
 	return rb_entry(&node->node, struct tag_stat, tn.node);
 }
 
+static struct hlist_head *tag_stat_hash_head(struct iface_stat *iface_entry,
+					     tag_t tag)
+{
+	return &iface_entry->tag_stat_hash[hash_64(tag, TAG_STAT_HASH_BITS)];
+}
+
+/*
+ * Caller must hold rcu_read_lock() or iface_entry->tag_stat_list_lock.
+ */
+static struct tag_stat *tag_stat_hash_search(struct iface_stat *iface_entry,
+					     tag_t tag)
+{
+	struct tag_stat *ts_entry;
+	struct hlist_node *node;
+
+	hlist_for_each_entry_rcu(ts_entry, node,
+				 tag_stat_hash_head(iface_entry, tag),
+				 hash_node) {
+		if (ts_entry->tn.tag == tag)
+			return ts_entry;
+	}
+	return NULL;
+}
+
 static void tag_counter_set_tree_insert(struct tag_counter_set *data,
 					struct rb_root *root)
 {
 	tag_node_tree_insert(&data->tn, root);
+	hlist_add_head_rcu(&data->hash_node,
+			   &tag_counter_set_hash[hash_64(data->tn.tag,
+						 TAG_COUNTER_SET_HASH_BITS)]);
+}
+
+static void tag_counter_set_tree_erase(struct tag_counter_set *data,
+				       struct rb_root *root)
+{
+	rb_erase(&data->tn.node, root);
+	hlist_del_rcu(&data->hash_node);
+	kfree_rcu(data, rcu);
+}
+
+/*
+ * Caller must hold rcu_read_lock() or tag_counter_set_list_lock.
+ */
+static struct tag_counter_set *tag_counter_set_hash_search(tag_t tag)
+{
+	struct tag_counter_set *tcs;
+	struct hlist_node *node;
+
+	hlist_for_each_entry_rcu(tcs, node,
+				 &tag_counter_set_hash[hash_64(tag,
+						 TAG_COUNTER_SET_HASH_BITS)],
+				 hash_node) {
+		if (tcs->tn.tag == tag)
+			return tcs;
+	}
+	return NULL;
 }
 
 static struct tag_counter_set *tag_counter_set_tree_search(struct rb_root *root,
@@ -413,7 +478,7 @@ static void sock_tag_tree_erase(struct rb_root *st_to_free_tree)
 			 get_uid_from_tag(st_entry->tag));
 		rb_erase(&st_entry->sock_node, st_to_free_tree);
 		sockfd_put(st_entry->socket);
-		kfree(st_entry);
+		kfree_rcu(st_entry, rcu);
 	}
 }
 
@@ -734,11 +799,11 @@ static int get_active_counter_set(tag_t tag)
 		 tag, get_uid_from_tag(tag));
 	/* For now we only handle UID tags for active sets */
 	tag = get_utag_from_tag(tag);
-	spin_lock_bh(&tag_counter_set_list_lock);
-	tcs = tag_counter_set_tree_search(&tag_counter_set_tree, tag);
+	rcu_read_lock();
+	tcs = tag_counter_set_hash_search(tag);
 	if (tcs)
-		active_set = tcs->active_set;
-	spin_unlock_bh(&tag_counter_set_list_lock);
+		active_set = ACCESS_ONCE(tcs->active_set);
+	rcu_read_unlock();
 	return active_set;
 }
 
@@ -766,6 +831,29 @@ done:
 	return iface_entry;
 }
 
+/*
+ * Find the entry for the device a packet goes through.
+ * Active entries are matched by ifindex. Data is still accounted to an
+ * inactive entry (e.g. in flight while the device goes away), and those
+ * can only be matched by name.
+ * Caller must hold rcu_read_lock(). The entries are never freed, so the
+ * result can be used after rcu_read_unlock().
+ */
+static struct iface_stat *get_iface_entry_rcu(const struct net_device *net_dev)
+{
+	struct iface_stat *iface_entry;
+
+	list_for_each_entry_rcu(iface_entry, &iface_stat_list, list) {
+		if (iface_entry->ifindex == net_dev->ifindex)
+			return iface_entry;
+	}
+	list_for_each_entry_rcu(iface_entry, &iface_stat_list, list) {
+		if (!strcmp(net_dev->name, iface_entry->ifname))
+			return iface_entry;
+	}
+	return NULL;
+}
+
 /* This is for fmt2 only */
 static int pp_iface_stat_line(bool header, char *outp,
 			      int char_count, struct iface_stat *iface_entry)
@@ -784,9 +872,9 @@ static int pp_iface_stat_line(bool header, char *outp,
 			       "tx_other_bytes tx_other_packets\n"
 			);
 	} else {
-		struct data_counters *cnts;
+		struct data_counters counters, *cnts = &counters;
 		int cnt_set = 0;   /* We only use one set for the device */
-		cnts = &iface_entry->totals_via_skb;
+		pcpu_data_counters_sum(cnts, iface_entry->totals_via_skb);
 		len = snprintf(
 			outp, char_count,
 			"%s "
@@ -952,6 +1040,7 @@ static void _iface_stat_set_active(struct iface_stat *entry,
 {
 	if (activate) {
 		entry->net_dev = net_dev;
+		entry->ifindex = net_dev->ifindex;
 		entry->active = true;
 		IF_DEBUG("qtaguid: %s(%s): "
 			 "enable tracking. rfcnt=%d\n", __func__,
@@ -960,6 +1049,7 @@ static void _iface_stat_set_active(struct iface_stat *entry,
 	} else {
 		entry->active = false;
 		entry->net_dev = NULL;
+		entry->ifindex = 0;
 		IF_DEBUG("qtaguid: %s(%s): "
 			 "disable tracking. rfcnt=%d\n", __func__,
 			 entry->ifname,
@@ -987,6 +1077,14 @@ static struct iface_stat *iface_alloc(struct net_device *net_dev)
 		kfree(new_iface);
 		return NULL;
 	}
+	new_iface->totals_via_skb = pcpu_data_counters_alloc(GFP_ATOMIC);
+	if (new_iface->totals_via_skb == NULL) {
+		pr_err("qtaguid: iface_stat: create(%s): "
+		       "counters alloc failed\n", net_dev->name);
+		kfree(new_iface->ifname);
+		kfree(new_iface);
+		return NULL;
+	}
 	spin_lock_init(&new_iface->tag_stat_list_lock);
 	new_iface->tag_stat_tree = RB_ROOT;
 	_iface_stat_set_active(new_iface, net_dev, true);
@@ -1000,6 +1098,7 @@ static struct iface_stat *iface_alloc(struct net_device *net_dev)
 		pr_err("qtaguid: iface_stat: create(%s): "
 		       "work alloc failed\n", new_iface->ifname);
 		_iface_stat_set_active(new_iface, net_dev, false);
+		kfree(new_iface->totals_via_skb);
 		kfree(new_iface->ifname);
 		kfree(new_iface);
 		return NULL;
@@ -1007,7 +1106,7 @@ static struct iface_stat *iface_alloc(struct net_device *net_dev)
 	isw->iface_entry = new_iface;
 	INIT_WORK(&isw->iface_work, iface_create_proc_worker);
 	schedule_work(&isw->iface_work);
-	list_add(&new_iface->list, &iface_stat_list);
+	list_add_rcu(&new_iface->list, &iface_stat_list);
 	return new_iface;
 }
 
@@ -1188,16 +1287,13 @@ static struct sock_tag *get_sock_stat_nl(const struct sock *sk)
 	return sock_tag_tree_search(&sock_tag_tree, sk);
 }
 
-static struct sock_tag *get_sock_stat(const struct sock *sk)
+/*
+ * Publish (or clear when st is NULL) the tag of sk for the packet path.
+ * Caller must hold sock_tag_list_lock.
+ */
+static void set_sock_qtag(struct sock *sk, struct sock_tag *st)
 {
-	struct sock_tag *sock_tag_entry;
-	MT_DEBUG("qtaguid: get_sock_stat(sk=%p)\n", sk);
-	if (!sk)
-		return NULL;
-	spin_lock_bh(&sock_tag_list_lock);
-	sock_tag_entry = get_sock_stat_nl(sk);
-	spin_unlock_bh(&sock_tag_list_lock);
-	return sock_tag_entry;
+	rcu_assign_pointer(sk->sk_qtag, st);
 }
 
 static int ipx_proto(const struct sk_buff *skb,
@@ -1240,6 +1336,21 @@ data_counters_update(struct data_counters *dc, int set,
 	}
 }
 
+/*
+ * Account to the slot of the current CPU.
+ * Caller must have BHs disabled, as the xtables core does around matches.
+ */
+static void
+pcpu_data_counters_update(struct pcpu_data_counters *pdc, int set,
+			  enum ifs_tx_rx direction, int proto, int bytes)
+{
+	struct pcpu_data_counters *cpu_dc = &pdc[smp_processor_id()];
+
+	u64_stats_update_begin(&cpu_dc->syncp);
+	data_counters_update(&cpu_dc->dc, set, direction, proto, bytes);
+	u64_stats_update_end(&cpu_dc->syncp);
+}
+
 /*
  * Update stats for the specified interface. Do nothing if the entry
  * does not exist (when a device was never configured with an IP address).
@@ -1339,21 +1450,20 @@ static void iface_stat_update_from_skb(const struct sk_buff *skb,
 			 par->family, proto);
 	}
 
-	spin_lock_bh(&iface_stat_list_lock);
-	entry = get_iface_entry(el_dev->name);
+	rcu_read_lock();
+	entry = get_iface_entry_rcu(el_dev);
+	rcu_read_unlock();
 	if (entry == NULL) {
 		IF_DEBUG("qtaguid: iface_stat: %s(%s): not tracked\n",
 			 __func__, el_dev->name);
-		spin_unlock_bh(&iface_stat_list_lock);
 		return;
 	}
 
 	IF_DEBUG("qtaguid: %s(%s): entry=%p\n", __func__,
 		 el_dev->name, entry);
 
-	data_counters_update(&entry->totals_via_skb, 0, direction, proto,
-			     bytes);
-	spin_unlock_bh(&iface_stat_list_lock);
+	pcpu_data_counters_update(entry->totals_via_skb, 0, direction, proto,
+				  bytes);
 }
 
 static void tag_stat_update(struct tag_stat *tag_entry,
@@ -1365,68 +1475,90 @@ static void tag_stat_update(struct tag_stat *tag_entry,
 		 "dir=%d proto=%d bytes=%d)\n",
 		 tag_entry->tn.tag, get_uid_from_tag(tag_entry->tn.tag),
 		 active_set, direction, proto, bytes);
-	data_counters_update(&tag_entry->counters, active_set, direction,
-			     proto, bytes);
+	pcpu_data_counters_update(tag_entry->counters, active_set, direction,
+				  proto, bytes);
 	if (tag_entry->parent_counters)
-		data_counters_update(tag_entry->parent_counters, active_set,
-				     direction, proto, bytes);
+		pcpu_data_counters_update(tag_entry->parent_counters,
+					  active_set, direction, proto, bytes);
 }
 
 /*
  * Create a new entry for tracking the specified {acct_tag,uid_tag} within
- * the interface.
+ * the interface, and make it visible to the packet path.
  * iface_entry->tag_stat_list_lock should be held.
  */
 static struct tag_stat *create_if_tag_stat(struct iface_stat *iface_entry,
-					   tag_t tag)
+					   tag_t tag,
+					   struct pcpu_data_counters *parent)
 {
 	struct tag_stat *new_tag_stat_entry = NULL;
 	IF_DEBUG("qtaguid: iface_stat: %s(): ife=%p tag=0x%llx"
 		 " (uid=%u)\n", __func__,
 		 iface_entry, tag, get_uid_from_tag(tag));
-	new_tag_stat_entry = kzalloc(sizeof(*new_tag_stat_entry), GFP_ATOMIC);
+	new_tag_stat_entry = kzalloc(sizeof(*new_tag_stat_entry)
+				     + nr_cpu_ids
+				     * sizeof(struct pcpu_data_counters),
+				     GFP_ATOMIC);
 	if (!new_tag_stat_entry) {
 		pr_err("qtaguid: iface_stat: tag stat alloc failed\n");
 		goto done;
 	}
 	new_tag_stat_entry->tn.tag = tag;
+	new_tag_stat_entry->parent_counters = parent;
 	tag_stat_tree_insert(new_tag_stat_entry, &iface_entry->tag_stat_tree);
+	hlist_add_head_rcu(&new_tag_stat_entry->hash_node,
+			   tag_stat_hash_head(iface_entry, tag));
 done:
 	return new_tag_stat_entry;
 }
 
-static void if_tag_stat_update(const char *ifname, uid_t uid,
+/*
+ * Free an entry already unhashed by the caller.
+ * When a uid_tag entry goes, its acct_tag children point at its counters:
+ * unhash them all before freeing any, so that the RCU grace period covers
+ * every packet that could still be using the parent.
+ * iface_entry->tag_stat_list_lock should be held.
+ */
+static void erase_if_tag_stat(struct iface_stat *iface_entry,
+			      struct tag_stat *ts_entry)
+{
+	rb_erase(&ts_entry->tn.node, &iface_entry->tag_stat_tree);
+	kfree_rcu(ts_entry, rcu);
+}
+
+static void if_tag_stat_update(const struct net_device *net_dev, uid_t uid,
 			       const struct sock *sk, enum ifs_tx_rx direction,
 			       int proto, int bytes)
 {
 	struct tag_stat *tag_stat_entry;
 	tag_t tag, acct_tag;
 	tag_t uid_tag;
-	struct data_counters *uid_tag_counters;
+	struct pcpu_data_counters *uid_tag_counters;
 	struct sock_tag *sock_tag_entry;
 	struct iface_stat *iface_entry;
 	struct tag_stat *new_tag_stat = NULL;
 	MT_DEBUG("qtaguid: if_tag_stat_update(ifname=%s "
 		"uid=%u sk=%p dir=%d proto=%d bytes=%d)\n",
-		 ifname, uid, sk, direction, proto, bytes);
+		 net_dev->name, uid, sk, direction, proto, bytes);
 
-
-	iface_entry = get_iface_entry(ifname);
+	rcu_read_lock();
+	iface_entry = get_iface_entry_rcu(net_dev);
 	if (!iface_entry) {
+		rcu_read_unlock();
 		pr_err_ratelimited("qtaguid: iface_stat: stat_update() "
-				   "%s not found\n", ifname);
+				   "%s not found\n", net_dev->name);
 		return;
 	}
 	/* It is ok to process data when an iface_entry is inactive */
 
 	MT_DEBUG("qtaguid: iface_stat: stat_update() dev=%s entry=%p\n",
-		 ifname, iface_entry);
+		 net_dev->name, iface_entry);
 
 	/*
 	 * Look for a tagged sock.
 	 * It will have an acct_uid.
 	 */
-	sock_tag_entry = get_sock_stat(sk);
+	sock_tag_entry = sk ? rcu_dereference(sk->sk_qtag) : NULL;
 	if (sock_tag_entry) {
 		tag = sock_tag_entry->tag;
 		acct_tag = get_atag_from_tag(tag);
@@ -1439,6 +1571,16 @@ static void if_tag_stat_update(const char *ifname, uid_t uid,
 	MT_DEBUG("qtaguid: iface_stat: stat_update(): "
 		 " looking for tag=0x%llx (uid=%u) in ife=%p\n",
 		 tag, get_uid_from_tag(tag), iface_entry);
+
+	/* The common case: the {acct_tag,uid_tag} entry already exists */
+	tag_stat_entry = tag_stat_hash_search(iface_entry, tag);
+	if (likely(tag_stat_entry)) {
+		tag_stat_update(tag_stat_entry, direction, proto, bytes);
+		rcu_read_unlock();
+		return;
+	}
+	rcu_read_unlock();
+
 	/* Loop over tag list under this interface for {acct_tag,uid_tag} */
 	spin_lock_bh(&iface_entry->tag_stat_list_lock);
 
@@ -1463,20 +1605,20 @@ static void if_tag_stat_update(const char *ifname, uid_t uid,
 		 * No parent counters. So
 		 *  - No {0, uid_tag} stats and no {acc_tag, uid_tag} stats.
 		 */
-		new_tag_stat = create_if_tag_stat(iface_entry, uid_tag);
+		new_tag_stat = create_if_tag_stat(iface_entry, uid_tag, NULL);
 		if (!new_tag_stat)
 			goto unlock;
-		uid_tag_counters = &new_tag_stat->counters;
+		uid_tag_counters = new_tag_stat->counters;
 	} else {
-		uid_tag_counters = &tag_stat_entry->counters;
+		uid_tag_counters = tag_stat_entry->counters;
 	}
 
 	if (acct_tag) {
 		/* Create the child {acct_tag, uid_tag} and hook up parent. */
-		new_tag_stat = create_if_tag_stat(iface_entry, tag);
+		new_tag_stat = create_if_tag_stat(iface_entry, tag,
+						  uid_tag_counters);
 		if (!new_tag_stat)
 			goto unlock;
-		new_tag_stat->parent_counters = uid_tag_counters;
 	} else {
 		/*
 		 * For new_tag_stat to be still NULL here would require:
@@ -1736,7 +1878,7 @@ static void account_for_uid(const struct sk_buff *skb,
 			 el_dev->name,
 			 el_dev->type);
 
-		if_tag_stat_update(el_dev->name, uid,
+		if_tag_stat_update(el_dev, uid,
 				skb->sk ? skb->sk : alternate_sk,
 				par->in ? IFS_RX : IFS_TX,
 				ip_hdr(skb)->protocol, skb->len);
@@ -2109,6 +2251,7 @@ static int ctrl_cmd_delete(const char *input)
 
 		if (!acct_tag || st_entry->tag == tag) {
 			rb_erase(&st_entry->sock_node, &sock_tag_tree);
+			set_sock_qtag(st_entry->sk, NULL);
 			/* Can't sockfd_put() within spinlock, do it later. */
 			sock_tag_tree_insert(st_entry, &st_to_free_tree);
 			tr_entry = lookup_tag_ref(st_entry->tag, NULL);
@@ -2140,8 +2283,7 @@ static int ctrl_cmd_delete(const char *input)
 			 tcs_entry->tn.tag,
 			 get_uid_from_tag(tcs_entry->tn.tag),
 			 tcs_entry->active_set);
-		rb_erase(&tcs_entry->tn.node, &tag_counter_set_tree);
-		kfree(tcs_entry);
+		tag_counter_set_tree_erase(tcs_entry, &tag_counter_set_tree);
 	}
 	spin_unlock_bh(&tag_counter_set_list_lock);
 
@@ -2152,6 +2294,16 @@ static int ctrl_cmd_delete(const char *input)
 	spin_lock_bh(&iface_stat_list_lock);
 	list_for_each_entry(iface_entry, &iface_stat_list, list) {
 		spin_lock_bh(&iface_entry->tag_stat_list_lock);
+		/* Hide them from the packet path first, see erase_if_tag_stat() */
+		for (node = rb_first(&iface_entry->tag_stat_tree);
+		     node;
+		     node = rb_next(node)) {
+			ts_entry = rb_entry(node, struct tag_stat, tn.node);
+			entry_uid = get_uid_from_tag(ts_entry->tn.tag);
+			if (entry_uid == uid
+			    && (!acct_tag || ts_entry->tn.tag == tag))
+				hlist_del_rcu(&ts_entry->hash_node);
+		}
 		node = rb_first(&iface_entry->tag_stat_tree);
 		while (node) {
 			ts_entry = rb_entry(node, struct tag_stat, tn.node);
@@ -2170,9 +2322,7 @@ static int ctrl_cmd_delete(const char *input)
 					 input, iface_entry->ifname,
 					 get_atag_from_tag(ts_entry->tn.tag),
 					 entry_uid);
-				rb_erase(&ts_entry->tn.node,
-					 &iface_entry->tag_stat_tree);
-				kfree(ts_entry);
+				erase_if_tag_stat(iface_entry, ts_entry);
 			}
 		}
 		spin_unlock_bh(&iface_entry->tag_stat_list_lock);
@@ -2278,6 +2428,7 @@ static int ctrl_cmd_tag(const char *input)
 	struct socket *el_socket;
 	int res, argc;
 	struct sock_tag *sock_tag_entry;
+	struct sock_tag *new_sock_tag_entry;
 	struct tag_ref *tag_ref_entry;
 	struct uid_tag_data *uid_tag_data_entry;
 	struct proc_qtu_data *pqd_entry;
@@ -2328,12 +2479,26 @@ static int ctrl_cmd_tag(const char *input)
 	}
 	full_tag = combine_atag_with_uid(acct_tag, uid);
 
+	/*
+	 * Both a new tag and a retag need a new entry: the one published via
+	 * sk_qtag is never modified.
+	 */
+	new_sock_tag_entry = kzalloc(sizeof(*new_sock_tag_entry), GFP_KERNEL);
+	if (!new_sock_tag_entry) {
+		pr_err("qtaguid: ctrl_tag(%s): "
+		       "socket tag alloc failed\n",
+		       input);
+		res = -ENOMEM;
+		goto err_put;
+	}
+
 	spin_lock_bh(&sock_tag_list_lock);
 	sock_tag_entry = get_sock_stat_nl(el_socket->sk);
 	tag_ref_entry = get_tag_ref(full_tag, &uid_tag_data_entry);
 	if (IS_ERR(tag_ref_entry)) {
 		res = PTR_ERR(tag_ref_entry);
 		spin_unlock_bh(&sock_tag_list_lock);
+		kfree(new_sock_tag_entry);
 		goto err_put;
 	}
 	tag_ref_entry->num_sock_tags++;
@@ -2356,20 +2521,21 @@ static int ctrl_cmd_tag(const char *input)
 		BUG_ON(IS_ERR_OR_NULL(prev_tag_ref_entry));
 		BUG_ON(prev_tag_ref_entry->num_sock_tags <= 0);
 		prev_tag_ref_entry->num_sock_tags--;
-		sock_tag_entry->tag = full_tag;
+		/* Take over the old entry's spots in the tree and pid list */
+		*new_sock_tag_entry = *sock_tag_entry;
+		new_sock_tag_entry->tag = full_tag;
+		rb_replace_node(&sock_tag_entry->sock_node,
+				&new_sock_tag_entry->sock_node, &sock_tag_tree);
+		if (sock_tag_entry->list.next && sock_tag_entry->list.prev)
+			list_replace(&sock_tag_entry->list,
+				     &new_sock_tag_entry->list);
+		set_sock_qtag(el_socket->sk, new_sock_tag_entry);
+		kfree_rcu(sock_tag_entry, rcu);
+		sock_tag_entry = new_sock_tag_entry;
 	} else {
 		CT_DEBUG("qtaguid: ctrl_tag(%s): newtag for sk=%p\n",
 			 input, el_socket->sk);
-		sock_tag_entry = kzalloc(sizeof(*sock_tag_entry),
-					 GFP_ATOMIC);
-		if (!sock_tag_entry) {
-			pr_err("qtaguid: ctrl_tag(%s): "
-			       "socket tag alloc failed\n",
-			       input);
-			spin_unlock_bh(&sock_tag_list_lock);
-			res = -ENOMEM;
-			goto err_tag_unref_put;
-		}
+		sock_tag_entry = new_sock_tag_entry;
 		sock_tag_entry->sk = el_socket->sk;
 		sock_tag_entry->socket = el_socket;
 		sock_tag_entry->pid = current->tgid;
@@ -2396,6 +2562,7 @@ static int ctrl_cmd_tag(const char *input)
 		spin_unlock_bh(&uid_tag_data_tree_lock);
 
 		sock_tag_tree_insert(sock_tag_entry, &sock_tag_tree);
+		set_sock_qtag(el_socket->sk, sock_tag_entry);
 		atomic64_inc(&qtu_events.sockets_tagged);
 	}
 	spin_unlock_bh(&sock_tag_list_lock);
@@ -2405,10 +2572,6 @@ static int ctrl_cmd_tag(const char *input)
 		 atomic_long_read(&el_socket->file->f_count));
 	return 0;
 
-err_tag_unref_put:
-	BUG_ON(tag_ref_entry->num_sock_tags <= 0);
-	tag_ref_entry->num_sock_tags--;
-	free_tag_ref_from_utd_entry(tag_ref_entry, uid_tag_data_entry);
 err_put:
 	CT_DEBUG("qtaguid: ctrl_tag(%s): done. ...->f_count=%ld\n",
 		 input, atomic_long_read(&el_socket->file->f_count) - 1);
@@ -2462,6 +2625,7 @@ static int ctrl_cmd_untag(const char *input)
 	 * so it can do whatever it wants to it.
 	 */
 	rb_erase(&sock_tag_entry->sock_node, &sock_tag_tree);
+	set_sock_qtag(el_socket->sk, NULL);
 
 	tag_ref_entry = lookup_tag_ref(sock_tag_entry->tag, &utd_entry);
 	BUG_ON(!tag_ref_entry);
@@ -2498,7 +2662,7 @@ static int ctrl_cmd_untag(const char *input)
 		 atomic_long_read(&el_socket->file->f_count) - 1);
 	sockfd_put(el_socket);
 
-	kfree(sock_tag_entry);
+	kfree_rcu(sock_tag_entry, rcu);
 	atomic64_inc(&qtu_events.sockets_untagged);
 
 	return 0;
@@ -2577,6 +2741,8 @@ struct proc_print_info {
 	char **num_items_returned;
 	struct iface_stat *iface_entry;
 	struct tag_stat *ts_entry;
+	/* ts_entry's counters, summed over all CPUs */
+	struct data_counters counters;
 	int item_index;
 	int items_to_skip;
 	int char_count;
@@ -2617,7 +2783,7 @@ static int pp_stats_line(struct proc_print_info *ppi, int cnt_set)
 		}
 		if (ppi->item_index++ < ppi->items_to_skip)
 			return 0;
-		cnts = &ppi->ts_entry->counters;
+		cnts = &ppi->counters;
 		len = snprintf(
 			ppi->outp, ppi->char_count,
 			"%d %s 0x%llx %u %u "
@@ -2658,6 +2824,7 @@ static bool pp_sets(struct proc_print_info *ppi)
 {
 	int len;
 	int counter_set;
+	pcpu_data_counters_sum(&ppi->counters, ppi->ts_entry->counters);
 	for (counter_set = 0; counter_set < IFS_MAX_COUNTER_SETS;
 	     counter_set++) {
 		len = pp_stats_line(ppi, counter_set);
@@ -2865,6 +3032,7 @@ static int qtudev_release(struct inode *inode, struct file *file)
 		free_tag_ref_from_utd_entry(tr, utd_entry);
 
 		rb_erase(&st_entry->sock_node, &sock_tag_tree);
+		set_sock_qtag(st_entry->sk, NULL);
 		list_del(&st_entry->list);
 		/* Can't sockfd_put() within spinlock, do it later. */
 		sock_tag_tree_insert(st_entry, &st_to_free_tree);
@@ -11,8 +11,12 @@
 #define __XT_QTAGUID_INTERNAL_H__
 
 #include <linux/types.h>
+#include <linux/cpumask.h>
 #include <linux/rbtree.h>
+#include <linux/rcupdate.h>
 #include <linux/spinlock_types.h>
+#include <linux/string.h>
+#include <linux/u64_stats_sync.h>
 #include <linux/workqueue.h>
 
 /* Iface handling */
@@ -179,6 +183,19 @@ struct data_counters {
 	struct byte_packet_counters bpc[IFS_MAX_COUNTER_SETS][IFS_MAX_DIRECTIONS][IFS_MAX_PROTOS];
 };
 
+/*
+ * One CPU's share of a data_counters.
+ * The packet path only ever touches the slot of the CPU it runs on, so
+ * it needs no lock. Readers add up all nr_cpu_ids slots, using syncp to
+ * get consistent 64bit values on 32bit hosts.
+ * The slots are allocated as a plain array because alloc_percpu() can
+ * sleep, and new tag stats get created from the packet path.
+ */
+struct pcpu_data_counters {
+	struct data_counters dc;
+	struct u64_stats_sync syncp;
+} ____cacheline_aligned_in_smp;
+
 static inline uint64_t dc_sum_bytes(struct data_counters *counters,
 				    int set,
 				    enum ifs_tx_rx direction)
@@ -197,6 +214,31 @@ static inline uint64_t dc_sum_packets(struct data_counters *counters,
 		+ counters->bpc[set][direction][IFS_PROTO_OTHER].packets;
 }
 
+/* Fold all nr_cpu_ids slots of pdc into sum */
+static inline void pcpu_data_counters_sum(struct data_counters *sum,
+					  const struct pcpu_data_counters *pdc)
+{
+	struct data_counters snap;
+	unsigned int start;
+	int cpu, set, dir, proto;
+
+	memset(sum, 0, sizeof(*sum));
+	for_each_possible_cpu(cpu) {
+		do {
+			start = u64_stats_fetch_begin(&pdc[cpu].syncp);
+			snap = pdc[cpu].dc;
+		} while (u64_stats_fetch_retry(&pdc[cpu].syncp, start));
+		for (set = 0; set < IFS_MAX_COUNTER_SETS; set++)
+			for (dir = 0; dir < IFS_MAX_DIRECTIONS; dir++)
+				for (proto = 0; proto < IFS_MAX_PROTOS;
+				     proto++) {
+					sum->bpc[set][dir][proto].bytes +=
+						snap.bpc[set][dir][proto].bytes;
+					sum->bpc[set][dir][proto].packets +=
+						snap.bpc[set][dir][proto].packets;
+				}
+	}
+}
 
 /* Generic X based nodes used as a base for rb_tree ops */
 struct tag_node {
@@ -204,14 +246,24 @@ struct tag_node {
 	tag_t tag;
 };
 
+/* Buckets in each iface_stat.tag_stat_hash */
+#define TAG_STAT_HASH_BITS 6
+
 struct tag_stat {
 	struct tag_node tn;
-	struct data_counters counters;
+	/*
+	 * The packet path finds the tag_stat via the RCU hash, the tn rbtree
+	 * is kept for ordered walks under tag_stat_list_lock.
+	 */
+	struct hlist_node hash_node;
+	struct rcu_head rcu;
 	/*
 	 * If this tag is acct_tag based, we need to count against the
 	 * matching parent uid_tag.
 	 */
-	struct data_counters *parent_counters;
+	struct pcpu_data_counters *parent_counters;
+	/* nr_cpu_ids entries */
+	struct pcpu_data_counters counters[0];
 };
 
 struct iface_stat {
@@ -221,8 +273,12 @@ struct iface_stat {
 	/* net_dev is only valid for active iface_stat */
 	struct net_device *net_dev;
 
+	/* ifindex of net_dev, only valid for active iface_stat */
+	int ifindex;
+
 	struct byte_packet_counters totals_via_dev[IFS_MAX_DIRECTIONS];
-	struct data_counters totals_via_skb;
+	/* nr_cpu_ids entries, only set 0 is used */
+	struct pcpu_data_counters *totals_via_skb;
 	/*
 	 * We keep the last_known, because some devices reset their counters
 	 * just before NETDEV_UP, while some will reset just before
@@ -238,6 +294,8 @@ struct iface_stat {
 	struct proc_dir_entry *proc_ptr;
 
 	struct rb_root tag_stat_tree;
+	struct hlist_head tag_stat_hash[1 << TAG_STAT_HASH_BITS];
+	/* Serializes tag_stat_tree and tag_stat_hash updates */
 	spinlock_t tag_stat_list_lock;
 };
 
@@ -255,14 +313,23 @@ struct iface_stat_work {
  */
 struct sock_tag {
 	struct rb_node sock_node;
-	struct sock *sk;  /* Only used as a number, never dereferenced */
+	/*
+	 * Kept alive by the socket reference below. Its sk_qtag points back
+	 * at us for as long as we are in the sock_tag_tree.
+	 */
+	struct sock *sk;
 	/* The socket is needed for sockfd_put() */
 	struct socket *socket;
 	/* Used to associate with a given pid */
 	struct list_head list;   /* in proc_qtu_data.sock_tag_list */
 	pid_t pid;
 
+	/*
+	 * Never changed once published via sk_qtag: a retag swaps in a new
+	 * sock_tag, so the packet path can't see a torn 64bit value.
+	 */
 	tag_t tag;
+	struct rcu_head rcu;
 };
 
 struct qtaguid_event_counts {
@@ -297,9 +364,15 @@ struct qtaguid_event_counts {
 	atomic64_t match_no_sk_file;
 };
 
+/* Buckets in tag_counter_set_hash */
+#define TAG_COUNTER_SET_HASH_BITS 6
+
 /* Track the set active_set for the given tag. */
 struct tag_counter_set {
 	struct tag_node tn;
+	/* For the packet path, see tag_stat.hash_node */
+	struct hlist_node hash_node;
+	struct rcu_head rcu;
 	int active_set;
 };
 
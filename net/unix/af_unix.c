@@ -536,6 +536,11 @@ static int unix_release_sock(struct sock *sk, int embrion)
 		kfree_skb(skb);
 	}
 
+	/* the cached skb is charged to sk_wmem_alloc and pins the socket */
+	skb = xchg(&u->skb_cache, NULL);
+	if (skb)
+		consume_skb(skb);
+
 	if (dentry) {
 		dput(dentry);
 		mntput(mnt);
@@ -741,6 +746,7 @@ static struct sock *unix_create1(struct net *net, struct socket *sock)
 	u	  = unix_sk(sk);
 	u->dentry = NULL;
 	u->mnt	  = NULL;
+	u->skb_cache = NULL;
 	spin_lock_init(&u->lock);
 	atomic_long_set(&u->inflight, 0);
 	INIT_LIST_HEAD(&u->link);
@@ -1508,6 +1514,93 @@ static int unix_scm_to_skb(struct scm_cookie *scm, struct sk_buff *skb, bool sen
 	return err;
 }
 
+/*
+ *	A socket keeps the last skb it consumed, if small enough, and
+ *	reuses it for its next send. Request/reply traffic between a
+ *	daemon and its clients then runs without touching the slab
+ *	for the skb head and data. The cached skb stays charged to the
+ *	socket's sk_wmem_alloc, so it counts against the send buffer
+ *	like an skb in flight.
+ */
+#define UNIX_SKB_CACHE_MAX	SKB_MAX_HEAD(0)
+
+static void unix_skb_recycle(struct sock *sk, struct sk_buff *skb)
+{
+	struct unix_sock *u = unix_sk(sk);
+
+	if (u->skb_cache ||
+	    skb_end_pointer(skb) - skb->head > UNIX_SKB_CACHE_MAX ||
+	    !skb_recycle_check(skb, 0)) {
+		consume_skb(skb);
+		return;
+	}
+
+	/* skb_recycle_check() leaves NET_SKB_PAD of headroom, we want none */
+	skb->data = skb->head;
+	skb_reset_tail_pointer(skb);
+	skb_set_owner_w(skb, sk);
+
+	skb = xchg(&u->skb_cache, skb);
+	if (skb)
+		consume_skb(skb);
+}
+
+static struct sk_buff *unix_alloc_send_skb(struct sock *sk, unsigned long size,
+					   int noblock, int *errcode)
+{
+	struct unix_sock *u = unix_sk(sk);
+	struct sk_buff *skb;
+
+	/* anything that would make sock_alloc_send_skb() wait or fail
+	 * takes the slow path
+	 */
+	if (!u->skb_cache || sk->sk_err || (sk->sk_shutdown & SEND_SHUTDOWN) ||
+	    atomic_read(&sk->sk_wmem_alloc) >= sk->sk_sndbuf)
+		goto slow;
+
+	skb = xchg(&u->skb_cache, NULL);
+	if (!skb)
+		goto slow;
+	if (skb_tailroom(skb) < size) {
+		consume_skb(skb);
+		goto slow;
+	}
+	return skb;
+
+slow:
+	return sock_alloc_send_skb(sk, size, noblock, errcode);
+}
+
+/*
+ *	Queue an skb on a connected peer without taking its state lock.
+ *	unix_release_sock() marks the socket dead and shut down before it
+ *	drains the receive queue under the queue lock, so checking both
+ *	under that lock never strands an skb on a released socket.
+ *	Messages passing fds, or raising the peer's recursion level,
+ *	need the state lock. Returns false if the caller must take the
+ *	locked path, which also reports a dead or shut down peer.
+ */
+static bool unix_queue_to_peer(struct sock *other, struct sk_buff *skb,
+			       int max_level)
+{
+	struct sk_buff_head *list = &other->sk_receive_queue;
+	unsigned long flags;
+	bool queued = false;
+
+	if (UNIXCB(skb).fp || max_level > unix_sk(other)->recursion_level)
+		return false;
+
+	spin_lock_irqsave(&list->lock, flags);
+	if (!sock_flag(other, SOCK_DEAD) &&
+	    !(other->sk_shutdown & RCV_SHUTDOWN)) {
+		__skb_queue_tail(list, skb);
+		queued = true;
+	}
+	spin_unlock_irqrestore(&list->lock, flags);
+
+	return queued;
+}
+
 /*
  *	Send AF_UNIX data.
  */
@@ -1562,7 +1655,7 @@ static int unix_dgram_sendmsg(struct kiocb *kiocb, struct socket *sock,
 	if (len > sk->sk_sndbuf - 32)
 		goto out;
 
-	skb = sock_alloc_send_skb(sk, len, msg->msg_flags&MSG_DONTWAIT, &err);
+	skb = unix_alloc_send_skb(sk, len, msg->msg_flags&MSG_DONTWAIT, &err);
 	if (skb == NULL)
 		goto out;
 
@@ -1597,6 +1690,18 @@ restart:
 		goto out_free;
 	}
 
+	/* A connected SOCK_SEQPACKET pair may always send to each other */
+	if (sk->sk_type == SOCK_SEQPACKET && unix_peer(other) == sk) {
+		if (sock_flag(other, SOCK_RCVTSTAMP))
+			__net_timestamp(skb);
+		if (unix_queue_to_peer(other, skb, max_level)) {
+			other->sk_data_ready(other, len);
+			sock_put(other);
+			scm_destroy(siocb->scm);
+			return len;
+		}
+	}
+
 	sk_locked = 0;
 	unix_state_lock(other);
 restart_locked:
@@ -1758,7 +1863,7 @@ static int unix_stream_sendmsg(struct kiocb *kiocb, struct socket *sock,
 		 *	Grab a buffer
 		 */
 
-		skb = sock_alloc_send_skb(sk, size, msg->msg_flags&MSG_DONTWAIT,
+		skb = unix_alloc_send_skb(sk, size, msg->msg_flags&MSG_DONTWAIT,
 					  &err);
 
 		if (skb == NULL)
@@ -1789,16 +1894,18 @@ static int unix_stream_sendmsg(struct kiocb *kiocb, struct socket *sock,
 			goto out_err;
 		}
 
-		unix_state_lock(other);
+		if (!unix_queue_to_peer(other, skb, max_level)) {
+			unix_state_lock(other);
 
-		if (sock_flag(other, SOCK_DEAD) ||
-		    (other->sk_shutdown & RCV_SHUTDOWN))
-			goto pipe_err_free;
+			if (sock_flag(other, SOCK_DEAD) ||
+			    (other->sk_shutdown & RCV_SHUTDOWN))
+				goto pipe_err_free;
 
-		skb_queue_tail(&other->sk_receive_queue, skb);
-		if (max_level > unix_sk(other)->recursion_level)
-			unix_sk(other)->recursion_level = max_level;
-		unix_state_unlock(other);
+			skb_queue_tail(&other->sk_receive_queue, skb);
+			if (max_level > unix_sk(other)->recursion_level)
+				unix_sk(other)->recursion_level = max_level;
+			unix_state_unlock(other);
+		}
 		other->sk_data_ready(other, size);
 		sent += size;
 	}
@@ -1898,8 +2005,10 @@ static int unix_dgram_recvmsg(struct kiocb *iocb, struct socket *sock,
 		goto out_unlock;
 	}
 
-	wake_up_interruptible_sync_poll(&u->peer_wait,
-					POLLOUT | POLLWRNORM | POLLWRBAND);
+	/* most of the time no writer is blocked on our queue */
+	if (wq_has_sleeper(&u->peer_wq))
+		wake_up_interruptible_sync_poll(&u->peer_wait,
+						POLLOUT | POLLWRNORM | POLLWRBAND);
 
 	if (msg->msg_name)
 		unix_copy_addr(msg, skb->sk);
@@ -1947,7 +2056,8 @@ static int unix_dgram_recvmsg(struct kiocb *iocb, struct socket *sock,
 	scm_recv(sock, msg, siocb->scm, flags);
 
 out_free:
-	skb_free_datagram(sk, skb);
+	unix_skb_recycle(sk, skb);
+	sk_mem_reclaim_partial(sk);
 out_unlock:
 	mutex_unlock(&u->readlock);
 out:
@@ -2115,7 +2225,7 @@ static int unix_stream_recvmsg(struct kiocb *iocb, struct socket *sock,
 				break;
 			}
 
-			consume_skb(skb);
+			unix_skb_recycle(sk, skb);
 
 			if (siocb->scm->fp)
 				break;
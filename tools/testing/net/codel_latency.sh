@@ -0,0 +1,48 @@
+#!/bin/sh
+#
+# Latency under load with the pfifo, codel and fq_codel qdiscs.
+#
+# The link is set up by lib.sh, with the qdisc under test as the child
+# of the tbf bottleneck.  While FLOWS bulk TCP flows fill the link, ping
+# measures the round trip time of a sparse flow.  The test fails unless codel and
+# fq_codel keep the average RTT under LIMIT ms and below the pfifo one.
+#
+# Needs root, ip, tc, ping and iperf.  Settings can be overridden from
+# the environment:
+#
+#   RATE=5mbit DELAY=50ms LIMIT=150 sh codel_latency.sh
+#
+# Licensed under the terms of the GNU GPL License version 2
+
+RATE=${RATE:-10mbit}
+DELAY=${DELAY:-20ms}
+FLOWS=${FLOWS:-4}
+DURATION=${DURATION:-20}
+PINGS=${PINGS:-50}
+LIMIT=${LIMIT:-80}
+
+NAME=codel_latency
+SUBNET=10.199.0
+
+. "$(dirname "$0")/lib.sh"
+
+net_init
+
+ret=0
+net_set_qdisc pfifo limit 1000 || exit 1
+fifo=$(net_load_rtt $FLOWS)
+echo "pfifo: average RTT ${fifo:-?} ms"
+[ -n "$fifo" ] || ret=1
+
+for qdisc in codel fq_codel; do
+	net_set_qdisc $qdisc || exit 1
+	rtt=$(net_load_rtt $FLOWS)
+	echo "$qdisc: average RTT ${rtt:-?} ms"
+	if ! net_rtt_below "$rtt" "$fifo" $LIMIT; then
+		echo "FAIL: $qdisc average RTT must stay below $LIMIT ms and pfifo"
+		ret=1
+	fi
+done
+
+[ $ret -eq 0 ] && echo "PASS"
+exit $ret
@@ -0,0 +1,98 @@
+#
+# Shared plumbing for the latency tests in this directory.
+#
+# Two network namespaces, ${NAME}_tx and ${NAME}_rx, are joined by a
+# veth pair.  The sender's egress is shaped to RATE by a tbf root qdisc
+# (handle 1:), whose child the test picks with net_set_qdisc, and
+# netem on the receiver's egress delays the return path by DELAY.  An
+# iperf server runs in the receiver namespace.
+#
+# A test sets NAME, SUBNET (the first three octets of a /24), RATE,
+# DELAY, DURATION and PINGS, optionally CLEANUP_HOOK, sources this
+# file and calls net_init.
+#
+# Licensed under the terms of the GNU GPL License version 2
+
+TX=${NAME}_tx
+RX=${NAME}_rx
+TX_ADDR=$SUBNET.1
+RX_ADDR=$SUBNET.2
+
+net_cleanup()
+{
+	[ -n "$CLEANUP_HOOK" ] && $CLEANUP_HOOK
+	[ -n "$server" ] && kill $server 2>/dev/null
+	ip netns del $TX 2>/dev/null
+	ip netns del $RX 2>/dev/null
+}
+
+net_setup()
+{
+	ip netns add $TX || return 1
+	ip netns add $RX || return 1
+	ip link add veth_tx type veth peer name veth_rx || return 1
+	ip link set veth_tx netns $TX
+	ip link set veth_rx netns $RX
+	ip netns exec $TX ip addr add $TX_ADDR/24 dev veth_tx
+	ip netns exec $RX ip addr add $RX_ADDR/24 dev veth_rx
+	ip netns exec $TX ip link set lo up
+	ip netns exec $RX ip link set lo up
+	ip netns exec $TX ip link set veth_tx up
+	ip netns exec $RX ip link set veth_rx up
+
+	ip netns exec $RX tc qdisc add dev veth_rx root netem delay $DELAY ||
+		return 1
+	ip netns exec $TX tc qdisc add dev veth_tx root handle 1: \
+		tbf rate $RATE burst 16kb latency 5s || return 1
+
+	ip netns exec $RX iperf -s >/dev/null 2>&1 &
+	server=$!
+	sleep 1
+}
+
+# Check the tools, then set up the namespaces or exit
+net_init()
+{
+	for tool in ip tc ping iperf; do
+		if ! which $tool >/dev/null 2>&1; then
+			echo "$NAME: $tool not found"
+			exit 1
+		fi
+	done
+
+	trap net_cleanup EXIT
+	net_cleanup
+	if ! net_setup; then
+		echo "$NAME: setup failed, see config-net for the kernel options"
+		exit 1
+	fi
+}
+
+# Make the qdisc "$@" the child of the tbf bottleneck
+net_set_qdisc()
+{
+	ip netns exec $TX tc qdisc replace dev veth_tx parent 1:1 handle 10: \
+		"$@"
+}
+
+# Print the average ping RTT in ms while $1 bulk TCP flows run
+net_load_rtt()
+{
+	ip netns exec $TX iperf -c $RX_ADDR -P $1 -t $DURATION \
+		>/dev/null 2>&1 &
+	# let the flows leave slow start and fill the queue
+	sleep 5
+	ip netns exec $TX ping -q -c $PINGS -i 0.2 $RX_ADDR |
+		sed -n 's/.*= [0-9.]*\/\([0-9.]*\)\/.*/\1/p'
+	wait
+
+	ip netns exec $TX tc -s qdisc show dev veth_tx parent 1:1 >&2
+}
+
+# Succeed if RTT $1 is set and below both $2 and the limit $3 (ms)
+net_rtt_below()
+{
+	[ -n "$1" ] && [ -n "$2" ] &&
+		awk -v r="$1" -v f="$2" -v l="$3" \
+			'BEGIN { exit !(r < l && r < f) }'
+}
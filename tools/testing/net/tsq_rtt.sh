@@ -0,0 +1,62 @@
+#!/bin/sh
+#
+# RTT of a small flow next to a bulk TCP flow, with and without TCP
+# small queues.
+#
+# The link is set up by lib.sh, with a deep FIFO as the child of the
+# tbf bottleneck.  While one bulk TCP flow runs, ping measures the
+# round trip time of a small flow sharing the bottleneck.  This is done
+# once with net.ipv4.tcp_limit_output_bytes at its current value and
+# once with it raised so far that TSQ never throttles.  The test fails
+# unless the average RTT with TSQ stays under LIMIT ms and below the
+# one without.
+#
+# Needs root, ip, tc, ping and iperf.  Settings can be overridden from
+# the environment:
+#
+#   RATE=5mbit DELAY=50ms LIMIT=300 sh tsq_rtt.sh
+#
+# Licensed under the terms of the GNU GPL License version 2
+
+RATE=${RATE:-20mbit}
+DELAY=${DELAY:-20ms}
+DURATION=${DURATION:-20}
+PINGS=${PINGS:-50}
+LIMIT=${LIMIT:-150}
+
+NAME=tsq_rtt
+SUBNET=10.199.1
+SYSCTL=/proc/sys/net/ipv4/tcp_limit_output_bytes
+CLEANUP_HOOK=restore_sysctl
+
+restore_sysctl()
+{
+	[ -n "$saved" ] && echo $saved > $SYSCTL
+}
+
+. "$(dirname "$0")/lib.sh"
+
+if [ ! -w $SYSCTL ]; then
+	echo "$NAME: $SYSCTL not writable"
+	exit 1
+fi
+saved=$(cat $SYSCTL)
+
+net_init
+net_set_qdisc pfifo limit 10000 || exit 1
+
+ret=0
+echo 1073741824 > $SYSCTL
+off=$(net_load_rtt 1)
+echo "without TSQ: average RTT ${off:-?} ms"
+echo $saved > $SYSCTL
+on=$(net_load_rtt 1)
+echo "with TSQ ($saved bytes): average RTT ${on:-?} ms"
+
+if ! net_rtt_below "$on" "$off" $LIMIT; then
+	echo "FAIL: average RTT with TSQ must stay below $LIMIT ms and the one without"
+	ret=1
+fi
+
+[ $ret -eq 0 ] && echo "PASS"
+exit $ret
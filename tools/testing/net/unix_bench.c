@@ -0,0 +1,224 @@
+/* $(CROSS_COMPILE)cc -Wall -Wextra -O2 -o unix_bench unix_bench.c -lrt */
+
+/*
+ * AF_UNIX messaging benchmark.
+ *
+ * Two processes connected by a socketpair exchange messages and the
+ * sender reports messages per second.  By default the parent streams
+ * messages to the child; with -p every message is answered, which is
+ * the request/reply pattern of the Android daemons.  With -b the
+ * messages are sent and received in batches with sendmmsg() and
+ * recvmmsg().
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+
+#define MAX_BATCH	64
+
+static int type = SOCK_SEQPACKET;
+static size_t size = 64;
+static unsigned long count = 1000000;
+static unsigned int batch = 1;
+static int pingpong;
+
+static void die(const char *what)
+{
+	perror(what);
+	exit(1);
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+		"usage: %s [-t stream|dgram|seqpacket] [-s size] [-n count]\n"
+		"          [-b batch] [-p]\n", prog);
+	exit(2);
+}
+
+/* Send @n messages from @buf, batched if requested */
+static void send_msgs(int fd, char *buf, unsigned int n)
+{
+	struct mmsghdr msgs[MAX_BATCH];
+	struct iovec iov[MAX_BATCH];
+	unsigned int i;
+	int ret;
+
+	if (batch == 1) {
+		for (i = 0; i < n; i++)
+			if (send(fd, buf, size, 0) != (ssize_t)size)
+				die("send");
+		return;
+	}
+
+	memset(msgs, 0, sizeof(msgs));
+	for (i = 0; i < n; i++) {
+		iov[i].iov_base = buf;
+		iov[i].iov_len = size;
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+	for (i = 0; i < n; i += ret) {
+		ret = sendmmsg(fd, msgs + i, n - i, 0);
+		if (ret <= 0)
+			die("sendmmsg");
+	}
+}
+
+/* Receive @n messages into @buf; a stream socket just reads the bytes */
+static void recv_msgs(int fd, char *buf, unsigned int n)
+{
+	struct mmsghdr msgs[MAX_BATCH];
+	struct iovec iov[MAX_BATCH];
+	size_t want = n * size;
+	unsigned int i;
+	ssize_t len;
+	int ret;
+
+	if (type == SOCK_STREAM) {
+		while (want) {
+			len = recv(fd, buf, want < size * MAX_BATCH ?
+				   want : size * MAX_BATCH, 0);
+			if (len <= 0)
+				die("recv");
+			want -= len;
+		}
+		return;
+	}
+
+	if (batch == 1) {
+		for (i = 0; i < n; i++)
+			if (recv(fd, buf, size, 0) != (ssize_t)size)
+				die("recv");
+		return;
+	}
+
+	memset(msgs, 0, sizeof(msgs));
+	for (i = 0; i < n; i++) {
+		iov[i].iov_base = buf + i * size;
+		iov[i].iov_len = size;
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+	for (i = 0; i < n; i += ret) {
+		ret = recvmmsg(fd, msgs + i, n - i, 0, NULL);
+		if (ret <= 0)
+			die("recvmmsg");
+	}
+}
+
+static void child(int fd, char *buf)
+{
+	unsigned long done;
+	unsigned int n;
+
+	for (done = 0; done < count; done += n) {
+		n = count - done < batch ? count - done : batch;
+		recv_msgs(fd, buf, n);
+		if (pingpong)
+			send_msgs(fd, buf, n);
+	}
+	/* tell the parent everything arrived */
+	if (!pingpong && write(fd, "", 1) < 0)
+		die("write");
+	exit(0);
+}
+
+int main(int argc, char **argv)
+{
+	struct timespec start, end;
+	unsigned long done;
+	unsigned int n;
+	double secs;
+	char *buf;
+	int sv[2];
+	int status;
+	pid_t pid;
+	int c;
+
+	while ((c = getopt(argc, argv, "t:s:n:b:p")) != -1) {
+		switch (c) {
+		case 't':
+			if (!strcmp(optarg, "stream"))
+				type = SOCK_STREAM;
+			else if (!strcmp(optarg, "dgram"))
+				type = SOCK_DGRAM;
+			else if (!strcmp(optarg, "seqpacket"))
+				type = SOCK_SEQPACKET;
+			else
+				usage(argv[0]);
+			break;
+		case 's':
+			size = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			count = strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			batch = strtoul(optarg, NULL, 0);
+			break;
+		case 'p':
+			pingpong = 1;
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+	if (!size || !count || !batch || batch > MAX_BATCH)
+		usage(argv[0]);
+
+	buf = calloc(MAX_BATCH, size);
+	if (!buf)
+		die("calloc");
+
+	if (socketpair(AF_UNIX, type, 0, sv) < 0)
+		die("socketpair");
+
+	pid = fork();
+	if (pid < 0)
+		die("fork");
+	if (pid == 0) {
+		close(sv[0]);
+		child(sv[1], buf);
+	}
+	close(sv[1]);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (done = 0; done < count; done += n) {
+		n = count - done < batch ? count - done : batch;
+		send_msgs(sv[0], buf, n);
+		if (pingpong)
+			recv_msgs(sv[0], buf, n);
+	}
+	if (!pingpong && read(sv[0], buf, 1) != 1)
+		die("read");
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	if (waitpid(pid, &status, 0) < 0)
+		die("waitpid");
+	if (!WIFEXITED(status) || WEXITSTATUS(status))
+		fprintf(stderr, "receiver failed\n");
+
+	secs = end.tv_sec - start.tv_sec +
+	       (end.tv_nsec - start.tv_nsec) / 1e9;
+	printf("%s size %zu batch %u%s: %lu msgs in %.3fs, %.0f msgs/s\n",
+	       type == SOCK_STREAM ? "stream" :
+	       type == SOCK_DGRAM ? "dgram" : "seqpacket",
+	       size, batch, pingpong ? " pingpong" : "",
+	       count, secs, count / secs);
+
+	return 0;
+}